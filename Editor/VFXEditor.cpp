@@ -15,6 +15,11 @@ const char* KE_EDITOR::VFXEditor::GetWindowName() const
 	return myVFXSequence->myName.c_str();
 }
 
+KE_EDITOR::VFXEditor::~VFXEditor()
+{
+	if (myVFXSequence) { myVFXSequence->myManager->ReleaseVFXSequence(mySequenceIndex); }
+}
+
 void KE_EDITOR::VFXEditor::Init()
 {
 	myVFXManager = &KE_GLOBAL::blackboard.Get<KE::Graphics>()->GetVFXManager();
@@ -40,7 +45,7 @@ void KE_EDITOR::VFXEditor::Render()
 	myState.currentFloat += KE_GLOBAL::deltaTime * KE::VFX_SEQUENCE_FRAME_RATE * (float)myState.playing;
 	myState.currentFloat = KE::Wrap(myState.currentFloat, (float)mySequenceInterface.GetFrameMin(), (float)mySequenceInterface.GetFrameMax() - 1);
 	myState.current = (int)myState.currentFloat;
-	
+
 	ImGui::PushItemWidth(130);
 	ImGui::InputInt("Duration (VFX Frames)", &myVFXSequence->myDuration);
 	ImGui::SameLine();
@@ -65,18 +70,54 @@ void KE_EDITOR::VFXEditor::Render()
 			static_cast<int>(KE::eRenderLayers::Count) - 1,
 			EnumToString(static_cast<KE::eRenderLayers>(myState.previewLayer))
 		);
+		ImGui::SliderInt("LOD Level", &myState.previewLODLevel, 0, static_cast<int>(myVFXSequence->myLODLevels.size()));
 		ImGui::EndPopup();
 	}
 
-	if (ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_S, false)) { KE::VFXManager::SaveVFXSequence(myVFXSequence); }
 	ImGui::SameLine();
-	if (ImGui::Button("Save")) { KE::VFXManager::SaveVFXSequence(myVFXSequence); }
+	if (ImGui::Button("LOD Settings")) { ImGui::OpenPopup("vfxLODSettings"); }
+	if (ImGui::BeginPopup("vfxLODSettings"))
+	{
+		DisplayLODSettings();
+		ImGui::EndPopup();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Budget")) { ImGui::OpenPopup("vfxBudgetSettings"); }
+	if (ImGui::BeginPopup("vfxBudgetSettings"))
+	{
+		DisplayBudgetSettings();
+		ImGui::EndPopup();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Custom Attributes")) { ImGui::OpenPopup("vfxCustomAttributes"); }
+	if (ImGui::BeginPopup("vfxCustomAttributes"))
+	{
+		DisplayCustomAttributes();
+		ImGui::EndPopup();
+	}
+
+	if (ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_S, false)) { SaveSequence(); }
+	ImGui::SameLine();
+	if (ImGui::Button("Save")) { SaveSequence(); }
+	if (ImGui::BeginPopupContextItem("vfxSaveSettings"))
+	{
+		ImGui::Checkbox("Reduce Curves On Save", &myState.reduceCurvesOnSave);
+		ImGui::DragFloat("Curve Tolerance", &myState.curveTolerance, 0.0005f, 0.0f, 0.1f, "%.4f");
+		ImGui::EndPopup();
+	}
+	ImGui::SameLine();
+	DisplaySaveStatus();
 	ImGui::SameLine();
 	if (ImGui::Button("Load"))
 	{
-		myVFXManager->LoadVFXSequence(mySequenceIndex, myVFXSequence->myName);
+		myVFXManager->RevertVFXSequence(mySequenceIndex);
 		SetSequenceIndex(mySequenceIndex);
 	}
+	ImGui::SameLine();
+	bool hotReload = myVFXManager->IsHotReloadEnabled();
+	if (ImGui::Checkbox("Hot Reload", &hotReload)) { myVFXManager->SetHotReloadEnabled(hotReload); }
 
 	ImGui::PopItemWidth();
 
@@ -93,6 +134,8 @@ void KE_EDITOR::VFXEditor::Render()
 				ImSequencer::SEQUENCER_CHANGE_FRAME
 			);
 			if (currentCache != myState.current) { myState.currentFloat = (float)myState.current; }
+
+			DisplayCostEstimate();
 		}
 		ImGui::EndChild();
 
@@ -102,12 +145,32 @@ void KE_EDITOR::VFXEditor::Render()
 			const KE::VFXTimeStamp& selectedStamp = myVFXSequence->myTimestamps[myState.selected];
 			ImGui::Text("Selected: %d", myState.selected);
 
+			for (int lod = 0; lod < static_cast<int>(myVFXSequence->myLODLevels.size()); lod++)
+			{
+				bool visible = !myVFXSequence->IsTimestampHidden(lod + 1, myState.selected);
+				if (ImGui::Checkbox(std::format("Visible at LOD {}", lod + 1).c_str(), &visible))
+				{
+					myVFXSequence->SetTimestampHidden(lod + 1, myState.selected, !visible);
+				}
+				if (lod + 1 < static_cast<int>(myVFXSequence->myLODLevels.size())) { ImGui::SameLine(); }
+			}
+
 			switch (selectedStamp.myType)
 			{
 			case KE::VFXType::VFXMeshInstance:
 			{
-				KE::ModelData* modelData = myVFXSequence->myVFXMeshes[selectedStamp.myEffectIndex].GetModelData();
-				ImGuiHandler::DisplayModelData(modelData);
+				KE::VFXMeshInstance& mesh = myVFXSequence->myVFXMeshes[selectedStamp.myEffectIndex];
+				ImGuiHandler::DisplayModelData(mesh.GetModelData());
+				myVFXManager->AnalyzeVFXMesh(mesh);
+
+				int drawMode = static_cast<int>(mesh.GetDrawMode());
+				if (ImGui::Combo("Draw Mode", &drawMode, KE::VFXMeshDrawModeNames, static_cast<int>(KE::VFXMeshDrawMode::Count)))
+				{
+					mesh.SetDrawMode(static_cast<KE::VFXMeshDrawMode>(drawMode));
+				}
+				ImGui::TextDisabled("%s, %i pass(es)", KE::VFXMeshShapeNames[static_cast<int>(mesh.GetShape())], mesh.GetPasses().count);
+
+				DisplayCustomCurves(myVFXSequence->myTimestamps[myState.selected]);
 				break;
 			}
 			case KE::VFXType::ParticleEmitter:
@@ -129,17 +192,135 @@ void KE_EDITOR::VFXEditor::Render()
 		ImGui::EndTable();
 	}
 
+	//live players reuse their packages until the revision changes, so it only moves when something was edited
+	const size_t sequenceHash = HashSequenceState(*myVFXSequence);
+	if (sequenceHash != myState.sequenceHash)
+	{
+		myVFXSequence->myRevision++;
+		myState.sequenceHash = sequenceHash;
+	}
+
 	if (myState.preview)
 	{
-		if (myState.playing)
+		auto& templates = myVFXSequence->myParticleEmitters;
+		if (myPreviewEmitters.size() != templates.size() || (!myState.playing && myState.current != myState.lastPreviewFrame))
+		{
+			//scrubbing, rebuild the emitters at the new frame instead of letting them continue from wherever they were
+			myVFXManager->PrewarmSequenceEmitters(mySequenceIndex, myState.current, myState.previewTransform, myPreviewEmitters);
+		}
+		else if (myState.playing)
 		{
-			for (auto& em : myVFXSequence->myParticleEmitters)
+			for (int i = 0; i < static_cast<int>(myPreviewEmitters.size()); i++)
 			{
-				em.myEmitter.Update(myState.previewTransform);
+				//edits to the template show up in the preview without restarting it
+				KE::ParticleEmitter& emitter = myPreviewEmitters[i].myEmitter;
+				emitter.GetSharedAttributes() = templates[i].myEmitter.GetSharedAttributes();
+				emitter.Update(myState.previewTransform);
 			}
+		}
+		myState.lastPreviewFrame = myState.current;
+
+		myVFXManager->RenderVFXDirect(
+			mySequenceIndex,
+			myState.current,
+			&myState.previewTransform,
+			static_cast<KE::eRenderLayers>(myState.previewLayer),
+			myState.previewLODLevel,
+			myPreviewEmitters
+		);
+	}
+}
 
+size_t KE_EDITOR::VFXEditor::HashSequenceState(KE::VFXSequence& aSequence)
+{
+	//everything a cached package is built from, emitters aren't cached
+	size_t hash = 14695981039346656037ull;
+	const auto hashBytes = [&hash](const void* someData, size_t aSize)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(someData);
+		for (size_t i = 0; i < aSize; i++) { hash = (hash ^ bytes[i]) * 1099511628211ull; }
+	};
+	const auto hashCurve = [&hashBytes](const KE::VFXCurveDataSet& aCurve)
+	{
+		hashBytes(&aCurve.myType, sizeof(aCurve.myType));
+		hashBytes(&aCurve.myCustomIndex, sizeof(aCurve.myCustomIndex));
+		hashBytes(&aCurve.myCurveProfile, sizeof(aCurve.myCurveProfile));
+		hashBytes(&aCurve.myMinValue, sizeof(aCurve.myMinValue));
+		hashBytes(&aCurve.myMaxValue, sizeof(aCurve.myMaxValue));
+		hashBytes(aCurve.myData.data(), aCurve.myData.size() * sizeof(Vector2f));
+	};
+
+	hashBytes(&aSequence.myDuration, sizeof(aSequence.myDuration));
+	for (const KE::VFXTimeStamp& timestamp : aSequence.myTimestamps)
+	{
+		hashBytes(&timestamp.myStartpoint, sizeof(timestamp.myStartpoint));
+		hashBytes(&timestamp.myEndpoint, sizeof(timestamp.myEndpoint));
+		hashBytes(&timestamp.myEffectIndex, sizeof(timestamp.myEffectIndex));
+		hashBytes(&timestamp.myType, sizeof(timestamp.myType));
+		hashBytes(&timestamp.myLODHiddenMask, sizeof(timestamp.myLODHiddenMask));
+		for (const KE::VFXCurveDataSet& curve : timestamp.myCurveDataSets) { hashCurve(curve); }
+		for (const KE::VFXCurveDataSet& curve : timestamp.myCustomCurveDataSets) { hashCurve(curve); }
+	}
+	for (KE::VFXMeshInstance& mesh : aSequence.myVFXMeshes)
+	{
+		const auto& matrix = mesh.GetTransform()->GetMatrix();
+		const KE::VFXMeshDrawMode drawMode = mesh.GetDrawMode();
+		hashBytes(&matrix, sizeof(matrix));
+		hashBytes(&drawMode, sizeof(drawMode));
+	}
+	for (const KE::VFXLODLevel& lod : aSequence.myLODLevels)
+	{
+		hashBytes(&lod.myDistance, sizeof(lod.myDistance));
+	}
+	for (const KE::VFXCustomAttribute& attribute : aSequence.myCustomAttributes)
+	{
+		hashBytes(&attribute.myDefaultValue, sizeof(attribute.myDefaultValue));
+	}
+	return hash;
+}
+
+void KE_EDITOR::VFXEditor::DisplayLODSettings()
+{
+	auto& lodLevels = myVFXSequence->myLODLevels;
+	bool needsSort = false;
+
+	for (int i = 0; i < static_cast<int>(lodLevels.size()); i++)
+	{
+		KE::VFXLODLevel& lod = lodLevels[i];
+		ImGui::PushID(i);
+		ImGui::Text("LOD %d", i + 1);
+		ImGui::SameLine();
+		ImGui::PushItemWidth(100);
+		ImGui::DragFloat("Distance", &lod.myDistance, 0.5f, 0.0f, FLT_MAX);
+		needsSort |= ImGui::IsItemDeactivatedAfterEdit();
+		ImGui::SameLine();
+		ImGui::SliderFloat("Particle Multiplier", &lod.myParticleMultiplier, 0.0f, 1.0f);
+		ImGui::PopItemWidth();
+		ImGui::SameLine();
+		const bool remove = ImGui::Button("Remove");
+		ImGui::PopID();
+
+		if (remove)
+		{
+			myVFXSequence->RemoveLODLevel(i);
+			myState.previewLODLevel = std::min(myState.previewLODLevel, static_cast<int>(lodLevels.size()));
+			break;
+		}
+	}
+
+	if (lodLevels.size() < KE::VFX_MAX_LOD_LEVELS && ImGui::Button("Add LOD Level"))
+	{
+		KE::VFXLODLevel& lod = lodLevels.emplace_back();
+		if (lodLevels.size() > 1)
+		{
+			lod.myDistance = lodLevels[lodLevels.size() - 2].myDistance * 2.0f;
+			lod.myParticleMultiplier = lodLevels[lodLevels.size() - 2].myParticleMultiplier * 0.5f;
 		}
-		myVFXManager->RenderVFXDirect(mySequenceIndex, myState.current, &myState.previewTransform, static_cast<KE::eRenderLayers>(myState.previewLayer));
+	}
+
+	if (needsSort)
+	{
+		myVFXSequence->SortLODLevels();
 	}
 }
 
@@ -151,8 +332,244 @@ void KE_EDITOR::VFXEditor::SetSequenceIndex(int aSequenceIndex)
 
 void KE_EDITOR::VFXEditor::SetSequence(KE::VFXSequence* aVFXSequence)
 {
+	//the open sequence can have unsaved edits, it stays loaded for as long as it's open
+	aVFXSequence->myManager->AcquireVFXSequence(aVFXSequence->myIndex);
+	if (myVFXSequence) { myVFXSequence->myManager->ReleaseVFXSequence(mySequenceIndex); }
+
 	mySequenceIndex = aVFXSequence->myIndex;
 	myVFXSequence = aVFXSequence;
 	mySequenceInterface.Link(aVFXSequence);
+	myPreviewEmitters.clear();
+}
+void KE_EDITOR::VFXEditor::SaveSequence()
+{
+	myLastCurveReduction = {};
+	if (myState.reduceCurvesOnSave)
+	{
+		myLastCurveReduction = KE::ReduceVFXSequenceCurves(*myVFXSequence, myState.curveTolerance);
+	}
+	myVFXManager->SaveVFXSequenceAsync(myVFXSequence);
 }
+
+void KE_EDITOR::VFXEditor::DisplaySaveStatus()
+{
+	KE::VFXSequenceSaver& saver = myVFXManager->GetSequenceSaver();
+	myVFXManager->DispatchSaveResults();
+
+	if (saver.IsSaving(mySequenceIndex))
+	{
+		ImGui::TextDisabled("Saving...");
+		return;
+	}
+
+	const KE::VFXSaveResult* result = saver.GetLastResult(mySequenceIndex);
+	if (!result) { return; }
+
+	switch (result->status)
+	{
+	case KE::VFXSaveStatus::Written:
+		if (myLastCurveReduction.pointsRemoved > 0)
+		{
+			ImGui::TextDisabled("Saved, removed %i of %i curve points", myLastCurveReduction.pointsRemoved, myLastCurveReduction.pointsBefore);
+		}
+		else
+		{
+			ImGui::TextDisabled("Saved");
+		}
+		break;
+	case KE::VFXSaveStatus::WrittenToBackup:
+		ImGui::TextColored({ 1.0f, 0.8f, 0.2f, 1.0f }, "Saved to backup");
+		if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", result->filePath.c_str()); }
+		break;
+	case KE::VFXSaveStatus::Failed:
+		ImGui::TextColored({ 1.0f, 0.3f, 0.3f, 1.0f }, "Save failed");
+		break;
+	}
+}
+
+void KE_EDITOR::VFXEditor::DisplayBudgetSettings()
+{
+	KE::VFXBudget& budget = myVFXSequence->myBudget;
+	ImGui::PushItemWidth(100);
+	ImGui::DragInt("Particles", &budget.myMaxParticles, 16.0f, 0, INT_MAX);
+	ImGui::DragInt("Mesh Packages", &budget.myMaxMeshPackages, 1.0f, 0, INT_MAX);
+	ImGui::DragInt("Draw Calls", &budget.myMaxDrawCalls, 1.0f, 0, INT_MAX);
+	ImGui::DragFloat("Screen Coverage", &budget.myMaxScreenCoverage, 0.05f, 0.0f, FLT_MAX);
+	ImGui::PopItemWidth();
+}
+
+void KE_EDITOR::VFXEditor::DisplayCustomAttributes()
+{
+	auto& attributes = myVFXSequence->myCustomAttributes;
+
+	for (int i = 0; i < static_cast<int>(attributes.size()); i++)
+	{
+		ImGui::PushID(i);
+		ImGui::Text("%i: %s", i, attributes[i].myName.c_str());
+		ImGui::SameLine();
+		ImGui::PushItemWidth(100);
+		ImGui::DragFloat("Default", &attributes[i].myDefaultValue, 0.01f);
+		ImGui::PopItemWidth();
+		ImGui::SameLine();
+		const bool remove = ImGui::Button("Remove");
+		ImGui::PopID();
+
+		if (remove)
+		{
+			myVFXSequence->RemoveCustomAttribute(i);
+			break;
+		}
+	}
+
+	if (attributes.size() >= KE::VFX_MAX_CUSTOM_ATTRIBUTES)
+	{
+		ImGui::TextDisabled("Every slot of the instance buffer is in use");
+		return;
+	}
+
+	ImGui::PushItemWidth(160);
+	ImGui::InputText("##customAttributeName", myState.customAttributeName, sizeof(myState.customAttributeName));
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	if (ImGui::Button("Add Attribute") && myVFXSequence->AddCustomAttribute(myState.customAttributeName))
+	{
+		myState.customAttributeName[0] = '\0';
+	}
+}
+
+void KE_EDITOR::VFXEditor::DisplayCustomCurves(KE::VFXTimeStamp& aTimestamp)
+{
+	const auto& attributes = myVFXSequence->myCustomAttributes;
+	if (attributes.empty()) { return; }
+
+	ImGui::SeparatorText("Custom Attributes");
+	for (int i = 0; i < static_cast<int>(attributes.size()); i++)
+	{
+		KE::VFXCurveDataSet& curve = aTimestamp.myCustomCurveDataSets[i];
+		ImGui::PushID(i);
+
+		bool animated = curve.IsValid();
+		if (ImGui::Checkbox(attributes[i].myName.c_str(), &animated))
+		{
+			curve = {};
+			if (animated)
+			{
+				curve.myCustomIndex = i;
+				curve.myMinValue = 0.0f;
+				curve.myMaxValue = 1.0f;
+				curve.myData = { { 0.0f, 0.0f }, { 1.0f, 1.0f } };
+			}
+		}
+
+		if (!animated)
+		{
+			ImGui::SameLine();
+			ImGui::TextDisabled("%.3f", attributes[i].myDefaultValue);
+			ImGui::PopID();
+			continue;
+		}
+
+		ImGui::PushItemWidth(100);
+		int profile = static_cast<int>(curve.myCurveProfile);
+		if (ImGui::Combo("Profile", &profile, KE::VFXCurveProfileNames, static_cast<int>(KE::VFXCurveProfiles::Count)))
+		{
+			curve.myCurveProfile = static_cast<KE::VFXCurveProfiles>(profile);
+		}
+		ImGui::SameLine();
+		ImGui::DragFloat("Min", &curve.myMinValue, 0.01f);
+		ImGui::SameLine();
+		ImGui::DragFloat("Max", &curve.myMaxValue, 0.01f);
+		ImGui::PopItemWidth();
+
+		//the same evaluation the players use, sampled over the timestamp's window
+		const int frameCount = std::max(aTimestamp.myEndpoint - aTimestamp.myStartpoint + 1, 2);
+		std::vector<float> samples(frameCount);
+		for (int frame = 0; frame < frameCount; frame++)
+		{
+			samples[frame] = curve.GetEvaluatedValue(aTimestamp.myStartpoint + frame, aTimestamp.myStartpoint, aTimestamp.myEndpoint);
+		}
+		ImGui::PlotLines("##customCurve", samples.data(), frameCount, 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(-1.0f, 40.0f));
+
+		bool needsSort = false;
+		for (int p = 0; p < static_cast<int>(curve.myData.size()); p++)
+		{
+			ImGui::PushID(p);
+			ImGui::PushItemWidth(160);
+			ImGui::DragFloat2("##point", &curve.myData[p].x, 0.005f, 0.0f, 1.0f);
+			needsSort |= ImGui::IsItemDeactivatedAfterEdit();
+			ImGui::PopItemWidth();
+
+			//a curve needs two points to have a segment to evaluate
+			bool remove = false;
+			if (curve.myData.size() > 2)
+			{
+				ImGui::SameLine();
+				remove = ImGui::Button("Remove");
+			}
+			ImGui::PopID();
+
+			if (remove)
+			{
+				curve.myData.erase(curve.myData.begin() + p);
+				break;
+			}
+		}
+
+		if (ImGui::Button("Add Point"))
+		{
+			const float time = static_cast<float>(myState.current - aTimestamp.myStartpoint) / static_cast<float>(frameCount - 1);
+			curve.myData.push_back({ std::clamp(time, 0.0f, 1.0f), 0.5f });
+			needsSort = true;
+		}
+
+		if (needsSort)
+		{
+			std::ranges::sort(curve.myData, [](const Vector2f& a, const Vector2f& b) { return a.x < b.x; });
+		}
+
+		ImGui::PopID();
+	}
+}
+
+void KE_EDITOR::VFXEditor::DisplayCostEstimate()
+{
+	KE::EstimateVFXCost(KE::GetVFXCostSources(*myVFXSequence), myVFXSequence->myDuration, myCostEstimate);
+	if (myCostEstimate.frames.empty()) { return; }
+
+	const KE::VFXBudget& budget = myVFXSequence->myBudget;
+	const KE::VFXFrameCost& peak = myCostEstimate.peak;
+	const int frameCount = static_cast<int>(myCostEstimate.frames.size());
+
+	const auto plot = [&](const char* aLabel, float(*aGetter)(void*, int), float aPeak, float aBudget)
+	{
+		const bool overBudget = aPeak > aBudget;
+		if (overBudget) { ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4(0.9f, 0.2f, 0.2f, 1.0f)); }
+
+		const std::string overlay = std::format("{}: {:.0f} / {:.0f}", aLabel, aPeak, aBudget);
+		ImGui::PlotHistogram(aLabel, aGetter, &myCostEstimate, frameCount, 0, overlay.c_str(), 0.0f, std::max(aPeak, aBudget) * 1.1f, ImVec2(-1.0f, 40.0f));
+
+		if (overBudget) { ImGui::PopStyleColor(); }
+
+		//current frame marker, the plot spans the whole sequence like the timeline does
+		const ImVec2 min = ImGui::GetItemRectMin();
+		const ImVec2 max = ImGui::GetItemRectMax();
+		const float x = min.x + (max.x - min.x) * (static_cast<float>(myState.current) + 0.5f) / static_cast<float>(frameCount);
+		ImGui::GetWindowDrawList()->AddLine(ImVec2(x, min.y), ImVec2(x, max.y), IM_COL32(255, 255, 255, 160));
+	};
+
+	plot("Particles", [](void* aData, int anIndex) { return static_cast<float>(static_cast<KE::VFXCostEstimate*>(aData)->frames[anIndex].particles); },
+		static_cast<float>(peak.particles), static_cast<float>(budget.myMaxParticles));
+	plot("Meshes", [](void* aData, int anIndex) { return static_cast<float>(static_cast<KE::VFXCostEstimate*>(aData)->frames[anIndex].meshPackages); },
+		static_cast<float>(peak.meshPackages), static_cast<float>(budget.myMaxMeshPackages));
+	plot("Draw Calls", [](void* aData, int anIndex) { return static_cast<float>(static_cast<KE::VFXCostEstimate*>(aData)->frames[anIndex].drawCalls); },
+		static_cast<float>(peak.drawCalls), static_cast<float>(budget.myMaxDrawCalls));
+	plot("Coverage", [](void* aData, int anIndex) { return static_cast<KE::VFXCostEstimate*>(aData)->frames[anIndex].screenCoverage; },
+		peak.screenCoverage, budget.myMaxScreenCoverage);
+
+	for (const std::string& violation : KE::GetVFXBudgetViolations(myCostEstimate, budget))
+	{
+		ImGui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Over budget: %s", violation.c_str());
+	}
+}
+
 #endif
@@ -1,5 +1,7 @@
 #pragma once
 #include "Editor/Source/EditorGraphics.h"
+#include "Engine/Source/Graphics/FX/VFXCostAnalyzer.h"
+#include "Engine/Source/Graphics/FX/VFXCurveReduction.h"
 
 #ifndef KITTYENGINE_NO_EDITOR
 
@@ -30,10 +32,30 @@ namespace KE_EDITOR
 			bool preview = true;
 			Transform previewTransform;
 			int previewLayer = static_cast<int>(KE::eRenderLayers::Main);
+			int previewLODLevel = 0;
+			int lastPreviewFrame = -1;
+			bool reduceCurvesOnSave = false;
+			float curveTolerance = KE::VFX_CURVE_REDUCTION_TOLERANCE;
+			char customAttributeName[64] = "";
+			size_t sequenceHash = 0;
 		} myState;
 
+		std::vector<KE::VFXEmitter> myPreviewEmitters; //copies of the templates, live players copy the templates themselves
+		KE::VFXCostEstimate myCostEstimate;
+		KE::VFXCurveReductionReport myLastCurveReduction;
+
+		void DisplayLODSettings();
+		void DisplayBudgetSettings();
+		void DisplayCustomAttributes();
+		void DisplayCustomCurves(KE::VFXTimeStamp& aTimestamp);
+		void DisplaySaveStatus();
+		void SaveSequence();
+		void DisplayCostEstimate();
+		static size_t HashSequenceState(KE::VFXSequence& aSequence);
+
 	public:
 		VFXEditor(EditorWindowInput aStartupData = {}) : EditorWindowBase(aStartupData) {}
+		~VFXEditor();
 
 		const char* GetWindowName() const override;
 		void Init() override;
@@ -0,0 +1,215 @@
+#include "stdafx.h"
+
+#include "Editor/Source/Editor.h"
+#ifndef KITTYENGINE_NO_EDITOR
+
+#include "VFXProfilerWindow.h"
+
+#include "Engine/Source/Graphics/FX/VFXValidation.h"
+#include "Graphics/Graphics.h"
+#include "imgui/imgui.h"
+
+namespace
+{
+	enum class CostColumn
+	{
+		Sequence,
+		CPU,
+		Instances,
+		Packages,
+		Draws,
+		Particles,
+	};
+}
+
+const char* KE_EDITOR::VFXProfilerWindow::GetWindowName() const
+{
+	return "VFX Profiler";
+}
+
+void KE_EDITOR::VFXProfilerWindow::Init()
+{
+	myVFXManager = &KE_GLOBAL::blackboard.Get<KE::Graphics>()->GetVFXManager();
+}
+
+void KE_EDITOR::VFXProfilerWindow::Update()
+{
+	//every sequence, the top count is applied after sorting by whichever column is selected
+	myCosts = myVFXManager->GetSequenceCosts(-1);
+}
+
+void KE_EDITOR::VFXProfilerWindow::SortCosts(int aColumn, bool anAscending)
+{
+	//per instance mode sorts by the value that is displayed
+	const auto getValue = [this, aColumn](const KE::VFXSequenceCost& aCost) -> float
+	{
+		const float scale = myShowPerInstance && aCost.instances > 0.0f ? 1.0f / aCost.instances : 1.0f;
+		switch ((CostColumn)aColumn)
+		{
+		case CostColumn::Sequence: return (float)aCost.sequenceIndex;
+		case CostColumn::CPU: return aCost.cpuMicroseconds * scale;
+		case CostColumn::Instances: return aCost.instances;
+		case CostColumn::Packages: return aCost.packages * scale;
+		case CostColumn::Draws: return aCost.draws * scale;
+		case CostColumn::Particles: return aCost.particles * scale;
+		}
+		return 0.0f;
+	};
+
+	std::ranges::sort(myCosts, [&](const KE::VFXSequenceCost& a, const KE::VFXSequenceCost& b)
+	{
+		return anAscending ? getValue(a) < getValue(b) : getValue(a) > getValue(b);
+	});
+}
+
+void KE_EDITOR::VFXProfilerWindow::Render()
+{
+	ImGui::SetNextItemWidth(120.0f);
+	ImGui::SliderInt("Top Sequences", &myTopCount, 1, 50);
+	ImGui::SameLine();
+	ImGui::Checkbox("Per Instance", &myShowPerInstance);
+
+	KE::VFXProfiler& profiler = myVFXManager->GetProfiler();
+	ImGui::Text("Players: %lli  Packages: %lli  Draws: %lli  Particles: %lli",
+		profiler.GetCounterAverage(KE::VFXCounter::LivePlayers),
+		profiler.GetCounterAverage(KE::VFXCounter::RenderPackages),
+		profiler.GetCounterAverage(KE::VFXCounter::MeshDraws) + profiler.GetCounterAverage(KE::VFXCounter::SpriteDraws),
+		profiler.GetCounterAverage(KE::VFXCounter::Particles)
+	);
+
+	const ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_SortTristate | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY;
+	if (ImGui::BeginTable("VFX Sequence Costs", 6, flags, ImVec2(0.0f, 250.0f)))
+	{
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Sequence", ImGuiTableColumnFlags_WidthStretch, 0.0f, (ImGuiID)CostColumn::Sequence);
+		ImGui::TableSetupColumn("CPU (us)", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending, 0.0f, (ImGuiID)CostColumn::CPU);
+		ImGui::TableSetupColumn("Instances", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, (ImGuiID)CostColumn::Instances);
+		ImGui::TableSetupColumn("Packages", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, (ImGuiID)CostColumn::Packages);
+		ImGui::TableSetupColumn("Draws", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, (ImGuiID)CostColumn::Draws);
+		ImGui::TableSetupColumn("Particles", ImGuiTableColumnFlags_PreferSortDescending, 0.0f, (ImGuiID)CostColumn::Particles);
+		ImGui::TableHeadersRow();
+
+		//the list is refreshed every update, so it gets sorted every frame rather than only when the specs change
+		if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs(); sortSpecs && sortSpecs->SpecsCount > 0)
+		{
+			const ImGuiTableColumnSortSpecs& spec = sortSpecs->Specs[0];
+			SortCosts((int)spec.ColumnUserID, spec.SortDirection == ImGuiSortDirection_Ascending);
+			sortSpecs->SpecsDirty = false;
+		}
+
+		//unsorted the list keeps the manager's cpu order
+		if (myCosts.size() > static_cast<size_t>(myTopCount)) { myCosts.resize(myTopCount); }
+
+		for (const KE::VFXSequenceCost& cost : myCosts)
+		{
+			const float scale = myShowPerInstance && cost.instances > 0.0f ? 1.0f / cost.instances : 1.0f;
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", myVFXManager->GetVFXSequenceName(cost.sequenceIndex).c_str());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", cost.cpuMicroseconds * scale);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", cost.instances);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", cost.packages * scale);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", cost.draws * scale);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.0f", cost.particles * scale);
+		}
+
+		ImGui::EndTable();
+	}
+
+	if (ImGui::CollapsingHeader("Memory"))
+	{
+		DisplayMemory();
+	}
+
+	ImGui::SetNextItemWidth(200.0f);
+	ImGui::InputText("##TracePath", myTracePath, sizeof(myTracePath));
+	ImGui::SameLine();
+	if (ImGui::Button("Dump Chrome Trace"))
+	{
+		myVFXManager->DumpProfilerTrace(myTracePath);
+	}
+
+	//stops every playing vfx
+	if (ImGui::Button("Run Validation"))
+	{
+		myValidationFailures = KE::VFXValidation(*myVFXManager).Run();
+		myHasValidated = true;
+	}
+	if (myHasValidated)
+	{
+		ImGui::SameLine();
+		ImGui::TextDisabled("%i check(s) failed", (int)myValidationFailures.size());
+		for (const std::string& failure : myValidationFailures)
+		{
+			ImGui::TextUnformatted(failure.c_str());
+		}
+	}
+}
+
+void KE_EDITOR::VFXProfilerWindow::DisplayMemory()
+{
+	const KE::VFXMemoryStats& stats = myVFXManager->GetMemoryStats();
+	const auto kilobytes = [](size_t aBytes) { return static_cast<float>(aBytes) / 1024.0f; };
+
+	ImGui::Text("Total: %.1f KB  Peak: %.1f KB", kilobytes(stats.myCurrent.GetTotal()), kilobytes(stats.myPeakTotal));
+	ImGui::SameLine();
+	if (ImGui::Button("Reset Peaks")) { myVFXManager->ResetMemoryPeaks(); }
+
+	const KE::VFXResidencyStats& residency = myVFXManager->GetResidencyStats();
+	ImGui::Text("Resident: %i sequences, %.1f / %.1f KB  Evicted: %i", residency.myResidentCount, kilobytes(residency.myResidentBytes), kilobytes(residency.myBudget), residency.myEvictedCount);
+	ImGui::TextDisabled("%i evictions, %i reloads since startup", residency.myEvictions, residency.myReloads);
+
+	if (ImGui::BeginTable("VFX Memory Categories", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+	{
+		ImGui::TableSetupColumn("Category", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("Current (KB)");
+		ImGui::TableSetupColumn("Peak (KB)");
+		ImGui::TableHeadersRow();
+
+		for (int c = 0; c < static_cast<int>(KE::VFXMemoryCategory::Count); c++)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", KE::VFXMemoryCategoryNames[c]);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", kilobytes(stats.myCurrent.myBytes[c]));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", kilobytes(stats.myPeak.myBytes[c]));
+		}
+		ImGui::EndTable();
+	}
+
+	//largest sequences first, limited by the same top count as the cost table
+	std::vector<int> order(stats.mySequences.size());
+	for (int i = 0; i < static_cast<int>(order.size()); i++) { order[i] = i; }
+	std::ranges::sort(order, [&stats](int a, int b) { return stats.mySequences[a].GetTotal() > stats.mySequences[b].GetTotal(); });
+	order.resize(std::min(order.size(), static_cast<size_t>(myTopCount)));
+
+	if (ImGui::BeginTable("VFX Memory Sequences", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+	{
+		ImGui::TableSetupColumn("Sequence", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("Current (KB)");
+		ImGui::TableSetupColumn("Peak (KB)");
+		ImGui::TableHeadersRow();
+
+		for (const int i : order)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s%s", myVFXManager->GetVFXSequenceName(i).c_str(), myVFXManager->IsVFXSequenceResident(i) ? "" : " (evicted)");
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", kilobytes(stats.mySequences[i].GetTotal()));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", kilobytes(stats.mySequencePeaks[i]));
+		}
+		ImGui::EndTable();
+	}
+}
+
+#endif
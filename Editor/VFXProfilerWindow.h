@@ -0,0 +1,34 @@
+#pragma once
+#include "Editor/Source/EditorGraphics.h"
+
+#ifndef KITTYENGINE_NO_EDITOR
+
+namespace KE_EDITOR
+{
+	class VFXProfilerWindow : public EditorWindowBase
+	{
+		KE_EDITOR_FRIEND
+	private:
+		KE::VFXManager* myVFXManager = nullptr;
+
+		std::vector<KE::VFXSequenceCost> myCosts;
+		int myTopCount = 10;
+		bool myShowPerInstance = false;
+		char myTracePath[256] = "VFXTrace.json";
+		std::vector<std::string> myValidationFailures;
+		bool myHasValidated = false;
+
+		void SortCosts(int aColumn, bool anAscending);
+		void DisplayMemory();
+
+	public:
+		VFXProfilerWindow(EditorWindowInput aStartupData = {}) : EditorWindowBase(aStartupData) {}
+
+		const char* GetWindowName() const override;
+		void Init() override;
+		void Update() override;
+		void Render() override;
+	};
+}
+
+#endif
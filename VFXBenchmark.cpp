@@ -0,0 +1,417 @@
+#include "stdafx.h"
+#include "VFXBenchmark.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <External/Include/nlohmann/json.hpp>
+
+#include "VFXManager.h"
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	namespace
+	{
+		constexpr const char* VFX_BENCHMARK_SEQUENCE_NAME = "__VFXBenchmark";
+
+		class BenchmarkTimer
+		{
+		private:
+			std::chrono::steady_clock::time_point myStart = std::chrono::steady_clock::now();
+
+		public:
+			double GetMicroseconds() const
+			{
+				return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - myStart).count();
+			}
+		};
+
+		void AddSyntheticTimestamp(VFXSequence& aSequence, VFXType aType, int anEffectIndex, const VFXSyntheticSequenceDesc& aDesc, std::mt19937& aRandom)
+		{
+			const int duration = std::max(aDesc.duration, 2);
+			VFXTimeStamp& timestamp = aSequence.myTimestamps.emplace_back();
+			timestamp.myType = aType;
+			timestamp.myEffectIndex = anEffectIndex;
+			timestamp.myStartpoint = std::uniform_int_distribution(0, duration / 2)(aRandom);
+			timestamp.myEndpoint = std::min(timestamp.myStartpoint + std::uniform_int_distribution(duration / 4, duration / 2)(aRandom), duration - 1);
+
+			std::array<int, (int)VFXAttributeTypes::Count> attributes;
+			for (int i = 0; i < attributes.size(); i++) { attributes[i] = i; }
+			std::shuffle(attributes.begin(), attributes.end(), aRandom);
+
+			const int curveCount = std::clamp(aDesc.curvesPerTimestamp, 0, (int)VFXAttributeTypes::Count);
+			const int pointCount = std::max(aDesc.pointsPerCurve, 2);
+			for (int c = 0; c < curveCount; c++)
+			{
+				VFXCurveDataSet& curve = timestamp.myCurveDataSets[attributes[c]];
+				curve.myType = (VFXAttributeTypes)attributes[c];
+				curve.myCurveProfile = VFXCurveProfiles::Smooth;
+				curve.myMinValue = VFXCurveDefaults[attributes[c]].x;
+				curve.myMaxValue = VFXCurveDefaults[attributes[c]].y;
+
+				std::uniform_real_distribution value(curve.myMinValue, curve.myMaxValue);
+				curve.myData.reserve(pointCount);
+				for (int p = 0; p < pointCount; p++)
+				{
+					curve.myData.push_back({ (float)p / (float)(pointCount - 1), value(aRandom) });
+				}
+			}
+		}
+	}
+
+	void GenerateSyntheticVFXSequence(VFXSequence& aSequence, const VFXSyntheticSequenceDesc& aDesc)
+	{
+		std::mt19937 random(aDesc.seed);
+
+		aSequence.myDuration = aDesc.duration;
+		aSequence.myVFXMeshes = {};
+		aSequence.myParticleEmitters = {};
+		aSequence.myTimestamps = {};
+		aSequence.myLODLevels = {};
+
+		//model data points at the mesh transforms, so the meshes can't reallocate once added.
+		//everything is reserved exactly so the memory a desc generates is known up front
+		aSequence.myVFXMeshes.reserve(aDesc.meshTimestamps);
+		aSequence.myParticleEmitters.reserve(aDesc.emitterTimestamps);
+		aSequence.myTimestamps.reserve(aDesc.meshTimestamps + aDesc.emitterTimestamps);
+
+		for (int i = 0; i < aDesc.meshTimestamps; i++)
+		{
+			aSequence.AddVFXMeshInstance();
+			AddSyntheticTimestamp(aSequence, VFXType::VFXMeshInstance, i, aDesc, random);
+		}
+
+		for (int i = 0; i < aDesc.emitterTimestamps; i++)
+		{
+			aSequence.AddParticleEmitter();
+			AddSyntheticTimestamp(aSequence, VFXType::ParticleEmitter, i, aDesc, random);
+
+			VFXEmitter& emitter = aSequence.myParticleEmitters.back();
+			emitter.myStartFrame = aSequence.myTimestamps.back().myStartpoint;
+			emitter.myEndFrame = aSequence.myTimestamps.back().myEndpoint;
+		}
+	}
+
+	VFXBenchmark::VFXBenchmark(VFXManager& aManager, const VFXBenchmarkSettings& aSettings) : myManager(aManager), mySettings(aSettings)
+	{
+	}
+
+	const std::vector<VFXBenchmarkResult>& VFXBenchmark::Run()
+	{
+		myResults.clear();
+		myManager.ClearVFX();
+		CreateSequences();
+
+		const int maxInstances = mySettings.instanceCounts.empty() ? 0 : std::ranges::max(mySettings.instanceCounts);
+		myTransforms.resize(maxInstances);
+		const int gridSize = std::max(1, (int)std::sqrt((float)maxInstances));
+		for (int i = 0; i < maxInstances; i++)
+		{
+			myTransforms[i].SetPosition({ (float)(i % gridSize) * 2.0f, 0.0f, (float)(i / gridSize) * 2.0f });
+		}
+
+		for (const int instanceCount : mySettings.instanceCounts)
+		{
+			RunUpdate(instanceCount);
+			RunPrepareRenderData(instanceCount);
+			RunPackageSort(instanceCount);
+			RunTriggerStopChurn(instanceCount);
+		}
+		RunCurveEvaluation();
+		RunLoadSequence();
+
+		myManager.ClearVFX();
+		return myResults;
+	}
+
+	void VFXBenchmark::CreateSequences()
+	{
+		mySequenceIndices.clear();
+		for (int i = 0; i < mySettings.sequenceCount; i++)
+		{
+			//reuse the sequences of an earlier run instead of growing the manager every time
+			const std::string name = std::format("{}_{}", VFX_BENCHMARK_SEQUENCE_NAME, i);
+			const auto existing = std::ranges::find(myManager.myVFXSequences, name, &VFXSequence::myName);
+			const int index = existing != myManager.myVFXSequences.end() ? existing->myIndex : myManager.AddVFXSequence(name);
+
+			VFXSyntheticSequenceDesc desc = mySettings.sequence;
+			desc.seed += i;
+			GenerateSyntheticVFXSequence(*myManager.GetVFXSequence(index), desc);
+			mySequenceIndices.push_back(index);
+		}
+	}
+
+	void VFXBenchmark::TriggerInstances(int aCount, std::vector<VFXInstanceHandle>* anOutHandles)
+	{
+		for (int i = 0; i < aCount; i++)
+		{
+			const VFXRenderInput input(myTransforms[i], true, true);
+			const VFXInstanceHandle handle = myManager.TriggerVFXSequence(mySequenceIndices[i % mySequenceIndices.size()], input);
+			if (anOutHandles) { anOutHandles->push_back(handle); }
+		}
+	}
+
+	void VFXBenchmark::AddResult(const std::string& aName)
+	{
+		VFXBenchmarkResult& result = myResults.emplace_back();
+		result.name = aName;
+		result.samples = (int)mySamples.size();
+		if (mySamples.empty()) { return; }
+
+		std::ranges::sort(mySamples);
+		double total = 0.0;
+		for (const double sample : mySamples) { total += sample; }
+
+		result.mean = total / (double)mySamples.size();
+		result.median = mySamples[mySamples.size() / 2];
+		result.p95 = mySamples[std::min(mySamples.size() - 1, mySamples.size() * 95 / 100)];
+		result.min = mySamples.front();
+		mySamples.clear();
+	}
+
+	void VFXBenchmark::RunUpdate(int anInstanceCount)
+	{
+		TriggerInstances(anInstanceCount);
+		for (int i = 0; i < mySettings.warmupFrames; i++)
+		{
+			myManager.Update(mySettings.deltaTime);
+			myManager.EndFrame();
+		}
+
+		for (int i = 0; i < mySettings.frames; i++)
+		{
+			const BenchmarkTimer timer;
+			myManager.Update(mySettings.deltaTime);
+			mySamples.push_back(timer.GetMicroseconds());
+			myManager.EndFrame();
+		}
+
+		myManager.ClearVFX();
+		AddResult(std::format("Update/{}", anInstanceCount));
+	}
+
+	void VFXBenchmark::RunPrepareRenderData(int anInstanceCount)
+	{
+		TriggerInstances(anInstanceCount);
+		for (int i = 0; i < mySettings.warmupFrames; i++)
+		{
+			myManager.Update(mySettings.deltaTime);
+			myManager.EndFrame();
+		}
+
+		//warm, every sample moves the players one sequence frame on so the caches only skip the curves that hold still
+		auto& packages = myManager.myRenderSnapshots[myManager.myWriteSnapshot].myRenderPackages;
+		for (int i = 0; i < mySettings.frames; i++)
+		{
+			for (auto& playerData : myManager.myRenderQueue)
+			{
+				const int duration = std::max(myManager.myVFXSequences[playerData.mySequenceIndex].myDuration, 1);
+				playerData.myFrame = (playerData.myFrame + 1) % duration;
+			}
+
+			const BenchmarkTimer timer;
+			for (auto& playerData : myManager.myRenderQueue)
+			{
+				myManager.PrepareRenderData(playerData);
+			}
+			mySamples.push_back(timer.GetMicroseconds());
+			packages.clear();
+		}
+		AddResult(std::format("PrepareRenderData/{}", anInstanceCount));
+
+		//cold, every package is built from scratch as on a player's first frame or after an edit
+		for (int i = 0; i < mySettings.frames; i++)
+		{
+			for (auto& playerData : myManager.myRenderQueue)
+			{
+				playerData.myPackageCache.myFrame = -1;
+			}
+
+			const BenchmarkTimer timer;
+			for (auto& playerData : myManager.myRenderQueue)
+			{
+				myManager.PrepareRenderData(playerData);
+			}
+			mySamples.push_back(timer.GetMicroseconds());
+			packages.clear();
+		}
+		AddResult(std::format("PrepareRenderDataCold/{}", anInstanceCount));
+
+		myManager.ClearVFX();
+	}
+
+	void VFXBenchmark::RunPackageSort(int anInstanceCount)
+	{
+		TriggerInstances(anInstanceCount);
+		for (int i = 0; i < mySettings.warmupFrames; i++)
+		{
+			myManager.Update(mySettings.deltaTime);
+			myManager.EndFrame();
+		}
+
+		//one update fills the packages, the sort is then repeated over the same set
+		myManager.Update(mySettings.deltaTime);
+		for (int i = 0; i < mySettings.frames; i++)
+		{
+			const BenchmarkTimer timer;
+			myManager.BuildViewSubmissions();
+			mySamples.push_back(timer.GetMicroseconds());
+		}
+		myManager.EndFrame();
+
+		myManager.ClearVFX();
+		AddResult(std::format("PackageSort/{}", anInstanceCount));
+	}
+
+	void VFXBenchmark::RunTriggerStopChurn(int anInstanceCount)
+	{
+		std::vector<VFXInstanceHandle> handles;
+		handles.reserve(anInstanceCount);
+
+		for (int i = 0; i < mySettings.frames; i++)
+		{
+			const BenchmarkTimer timer;
+			TriggerInstances(anInstanceCount, &handles);
+			for (const VFXInstanceHandle handle : handles)
+			{
+				myManager.StopVFXInstance(handle);
+			}
+			mySamples.push_back(timer.GetMicroseconds());
+			handles.clear();
+		}
+
+		myManager.ClearVFX();
+		AddResult(std::format("TriggerStopChurn/{}", anInstanceCount));
+	}
+
+	void VFXBenchmark::RunCurveEvaluation()
+	{
+		float sink = 0.0f;
+		for (int i = 0; i < mySettings.frames; i++)
+		{
+			const BenchmarkTimer timer;
+			for (const int index : mySequenceIndices)
+			{
+				const VFXSequence& sq = *myManager.GetVFXSequence(index);
+				for (const VFXTimeStamp& timestamp : sq.myTimestamps)
+				{
+					for (const VFXCurveDataSet& curve : timestamp.myCurveDataSets)
+					{
+						if (!curve.IsValid()) { continue; }
+						for (int frame = timestamp.myStartpoint; frame <= timestamp.myEndpoint; frame++)
+						{
+							sink += curve.GetEvaluatedValue(frame, timestamp.myStartpoint, timestamp.myEndpoint);
+						}
+					}
+				}
+			}
+			mySamples.push_back(timer.GetMicroseconds());
+		}
+
+		//keeps the evaluation from being optimized away
+		volatile float result = sink;
+		(void)result;
+
+		AddResult("GetEvaluatedValue");
+	}
+
+	void VFXBenchmark::RunLoadSequence()
+	{
+		if (mySequenceIndices.empty()) { return; }
+
+		const int index = mySequenceIndices.front();
+		VFXSequence& sq = *myManager.GetVFXSequence(index);
+		VFXManager::SaveVFXSequence(&sq);
+
+		for (int i = 0; i < mySettings.loadIterations; i++)
+		{
+			const BenchmarkTimer timer;
+			myManager.LoadVFXSequence(index, sq.myName);
+			mySamples.push_back(timer.GetMicroseconds());
+		}
+
+		std::error_code error;
+		std::filesystem::remove(VFX_SEQUENCE_FILE_LOCATION + sq.myName + ".kittyVFX", error);
+
+		AddResult("LoadVFXSequence");
+	}
+
+	bool VFXBenchmark::WriteResults(const std::string& aFilePath) const
+	{
+		nlohmann::json output;
+		output["benchmarks"] = nlohmann::json::array();
+		for (const VFXBenchmarkResult& result : myResults)
+		{
+			output["benchmarks"].push_back({
+				{ "name", result.name },
+				{ "samples", result.samples },
+				{ "mean", result.mean },
+				{ "median", result.median },
+				{ "p95", result.p95 },
+				{ "min", result.min }
+			});
+		}
+
+		std::ofstream file(aFilePath);
+		if (!file.is_open())
+		{
+			KE_ERROR("Failed to write VFX benchmark results %s", aFilePath.c_str());
+			return false;
+		}
+
+		file << output.dump(4);
+		return true;
+	}
+
+	std::vector<VFXBenchmarkResult> VFXBenchmark::ReadResults(const std::string& aFilePath)
+	{
+		std::vector<VFXBenchmarkResult> results;
+
+		std::ifstream file(aFilePath);
+		if (!file.is_open())
+		{
+			KE_ERROR("Failed to open VFX benchmark results %s", aFilePath.c_str());
+			return results;
+		}
+
+		nlohmann::json input = nlohmann::json::parse(file, nullptr, false);
+		if (input.is_discarded() || !input.contains("benchmarks"))
+		{
+			KE_ERROR("Failed to parse VFX benchmark results %s", aFilePath.c_str());
+			return results;
+		}
+
+		for (const auto& benchmark : input["benchmarks"])
+		{
+			VFXBenchmarkResult& result = results.emplace_back();
+			result.name = benchmark["name"];
+			result.samples = benchmark["samples"];
+			result.mean = benchmark["mean"];
+			result.median = benchmark["median"];
+			result.p95 = benchmark["p95"];
+			result.min = benchmark["min"];
+		}
+
+		return results;
+	}
+
+	std::vector<std::string> VFXBenchmark::Compare(const std::vector<VFXBenchmarkResult>& aBaseline, const std::vector<VFXBenchmarkResult>& aCurrent, float aTolerance)
+	{
+		std::vector<std::string> regressions;
+		for (const VFXBenchmarkResult& current : aCurrent)
+		{
+			const auto baseline = std::ranges::find(aBaseline, current.name, &VFXBenchmarkResult::name);
+			if (baseline == aBaseline.end() || baseline->median <= 0.0) { continue; }
+
+			const double change = current.median / baseline->median - 1.0;
+			if (change > aTolerance)
+			{
+				regressions.push_back(std::format("{}: {:.1f}us -> {:.1f}us (+{:.0f}%)", current.name, baseline->median, current.median, change * 100.0));
+			}
+		}
+		return regressions;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Engine/Source/Graphics/FX/VFXResources.h"
+
+namespace KE
+{
+	class VFXManager;
+
+	struct VFXSyntheticSequenceDesc
+	{
+		int meshTimestamps = 4;
+		int emitterTimestamps = 2;
+		int curvesPerTimestamp = 4;
+		int pointsPerCurve = 8;
+		int duration = 2 * VFX_SEQUENCE_FRAME_RATE;
+		unsigned int seed = 1;
+	};
+
+	//fills the sequence with random timestamps and curves, the same desc always generates the same sequence
+	void GenerateSyntheticVFXSequence(VFXSequence& aSequence, const VFXSyntheticSequenceDesc& aDesc);
+
+	struct VFXBenchmarkSettings
+	{
+		std::vector<int> instanceCounts = { 10, 100, 1000, 10000 };
+		int sequenceCount = 4;
+		int warmupFrames = 30;
+		int frames = 120;
+		int loadIterations = 20;
+		float deltaTime = 1.0f / 60.0f;
+		VFXSyntheticSequenceDesc sequence;
+	};
+
+	struct VFXBenchmarkResult
+	{
+		std::string name;
+		int samples = 0;
+
+		//microseconds per sample
+		double mean = 0.0;
+		double median = 0.0;
+		double p95 = 0.0;
+		double min = 0.0;
+	};
+
+	//drives the cpu side of the manager with synthetic sequences, nothing gets rendered
+	class VFXBenchmark
+	{
+	private:
+		VFXManager& myManager;
+		VFXBenchmarkSettings mySettings;
+
+		std::vector<int> mySequenceIndices;
+		std::vector<Transform> myTransforms;
+		std::vector<VFXBenchmarkResult> myResults;
+		std::vector<double> mySamples;
+
+		void CreateSequences();
+		void TriggerInstances(int aCount, std::vector<VFXInstanceHandle>* anOutHandles = nullptr);
+		void AddResult(const std::string& aName);
+
+		void RunUpdate(int anInstanceCount);
+		void RunPrepareRenderData(int anInstanceCount);
+		void RunPackageSort(int anInstanceCount);
+		void RunTriggerStopChurn(int anInstanceCount);
+		void RunCurveEvaluation();
+		void RunLoadSequence();
+
+	public:
+		VFXBenchmark(VFXManager& aManager, const VFXBenchmarkSettings& aSettings = {});
+
+		//clears every playing vfx before and after
+		const std::vector<VFXBenchmarkResult>& Run();
+		inline const std::vector<VFXBenchmarkResult>& GetResults() const { return myResults; }
+
+		bool WriteResults(const std::string& aFilePath) const;
+		static std::vector<VFXBenchmarkResult> ReadResults(const std::string& aFilePath);
+
+		//one line per benchmark whose median got slower than the baseline by more than the tolerance
+		static std::vector<std::string> Compare(const std::vector<VFXBenchmarkResult>& aBaseline, const std::vector<VFXBenchmarkResult>& aCurrent, float aTolerance = 0.1f);
+	};
+}
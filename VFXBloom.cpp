@@ -0,0 +1,60 @@
+#include "stdafx.h"
+#include "VFXBloom.h"
+
+namespace KE
+{
+	VFXScreenRect GetVFXBloomRect(std::span<const VFXBloomContributor> someContributors, const DirectX::XMMATRIX& aViewProjection, int aWidth, int aHeight, int aPadding)
+	{
+		const VFXScreenRect screen = { 0, 0, aWidth, aHeight };
+
+		float minX = FLT_MAX;
+		float minY = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float maxY = -FLT_MAX;
+
+		for (const VFXBloomContributor& contributor : someContributors)
+		{
+			for (int corner = 0; corner < 8; corner++)
+			{
+				const DirectX::XMVECTOR position = DirectX::XMVectorSet(
+					contributor.center.x + (corner & 1 ? contributor.radius : -contributor.radius),
+					contributor.center.y + (corner & 2 ? contributor.radius : -contributor.radius),
+					contributor.center.z + (corner & 4 ? contributor.radius : -contributor.radius),
+					1.0f
+				);
+
+				DirectX::XMFLOAT4 clip;
+				DirectX::XMStoreFloat4(&clip, DirectX::XMVector4Transform(position, aViewProjection));
+				if (clip.w <= 1e-4f) { return screen; }
+
+				//ndc y points up, pixel rows go down
+				const float x = (clip.x / clip.w * 0.5f + 0.5f) * (float)aWidth;
+				const float y = (0.5f - clip.y / clip.w * 0.5f) * (float)aHeight;
+				minX = std::min(minX, x);
+				minY = std::min(minY, y);
+				maxX = std::max(maxX, x);
+				maxY = std::max(maxY, y);
+			}
+		}
+
+		if (minX > maxX) { return {}; }
+
+		VFXScreenRect rect;
+		rect.left = std::clamp((int)std::floor(minX) - aPadding, 0, aWidth);
+		rect.top = std::clamp((int)std::floor(minY) - aPadding, 0, aHeight);
+		rect.right = std::clamp((int)std::ceil(maxX) + aPadding, 0, aWidth);
+		rect.bottom = std::clamp((int)std::ceil(maxY) + aPadding, 0, aHeight);
+		return rect.IsEmpty() ? VFXScreenRect{} : rect;
+	}
+
+	VFXScreenRect GetVFXDownsampledRect(const VFXScreenRect& aRect, int aLevel)
+	{
+		const int scale = 1 << aLevel;
+		return {
+			aRect.left / scale,
+			aRect.top / scale,
+			(aRect.right + scale - 1) / scale,
+			(aRect.bottom + scale - 1) / scale
+		};
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <span>
+
+#include "Engine/Source/Math/KittyMath.h"
+
+namespace KE
+{
+	constexpr int VFX_BLOOM_SCISSOR_PADDING = 32; //pixels at full resolution, covers how far the gaussian spreads the glow
+	constexpr float VFX_BLOOM_MESH_RADIUS = 1.0f; //bounding radius of an unscaled effect mesh
+
+	//world space bounding sphere of something that writes into the bloom target this frame
+	struct VFXBloomContributor
+	{
+		Vector3f center;
+		float radius = 0.0f;
+	};
+
+	//pixels, right and bottom are exclusive
+	struct VFXScreenRect
+	{
+		int left = 0;
+		int top = 0;
+		int right = 0;
+		int bottom = 0;
+
+		inline bool IsEmpty() const { return right <= left || bottom <= top; }
+		inline int GetWidth() const { return right - left; }
+		inline int GetHeight() const { return bottom - top; }
+	};
+
+	//union of the projected bounds, padded and clamped to the screen. empty if nothing is in front of the camera and on screen,
+	//contributors crossing the near plane can't be projected and give the whole screen
+	VFXScreenRect GetVFXBloomRect(std::span<const VFXBloomContributor> someContributors, const DirectX::XMMATRIX& aViewProjection, int aWidth, int aHeight, int aPadding = VFX_BLOOM_SCISSOR_PADDING);
+
+	//the rect at a downsampled level of the bloom chain, rounded outwards so nothing on the border gets cut
+	VFXScreenRect GetVFXDownsampledRect(const VFXScreenRect& aRect, int aLevel);
+}
@@ -0,0 +1,68 @@
+#include "stdafx.h"
+#include "VFXCommandQueue.h"
+
+namespace KE
+{
+	VFXCommandQueue::VFXCommandQueue(size_t aCapacity) : myCells(std::make_unique<Cell[]>(aCapacity)), myMask(aCapacity - 1)
+	{
+		assert(aCapacity >= 2 && (aCapacity & (aCapacity - 1)) == 0 && "VFX command queue capacity has to be a power of two");
+
+		for (size_t i = 0; i < aCapacity; i++)
+		{
+			myCells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	bool VFXCommandQueue::TryPush(const VFXCommand& aCommand)
+	{
+		Cell* cell = nullptr;
+		size_t position = myEnqueuePosition.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			cell = &myCells[position & myMask];
+			const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+			if (difference == 0)
+			{
+				//the cell is free for this position, claim it unless another producer got there first
+				if (myEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				//the consumer hasn't freed the cell from the previous lap yet
+				return false;
+			}
+			else
+			{
+				position = myEnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->command = aCommand;
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool VFXCommandQueue::TryPop(VFXCommand& anOutCommand)
+	{
+		Cell& cell = myCells[myDequeuePosition & myMask];
+		const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+		//a claimed but unpublished cell stops the drain, so commands always come out in the order they were claimed
+		if (sequence != myDequeuePosition + 1)
+		{
+			return false;
+		}
+
+		anOutCommand = std::move(cell.command);
+		cell.command.renderInput.reset();
+		cell.sequence.store(myDequeuePosition + myMask + 1, std::memory_order_release);
+		myDequeuePosition++;
+		return true;
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "Engine/Source/Graphics/FX/VFXResources.h"
+
+namespace KE
+{
+	constexpr size_t VFX_COMMAND_QUEUE_CAPACITY = 4096; //has to be a power of two
+
+	enum class VFXCommandType : uint8_t
+	{
+		Trigger,
+		StopSequence,
+		StopInstance,
+		SetTransform,
+	};
+
+	struct VFXCommand
+	{
+		VFXCommandType type = VFXCommandType::Trigger;
+		int sequenceIndex = -1;
+		VFXInstanceHandle handle = VFX_INVALID_HANDLE;
+
+		std::optional<VFXRenderInput> renderInput; //trigger and stop sequence
+		Transform transform; //set transform
+	};
+
+	//bounded multi producer single consumer ring, every cell carries a sequence number so producers only contend on the enqueue counter
+	class VFXCommandQueue
+	{
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			VFXCommand command;
+		};
+
+		std::unique_ptr<Cell[]> myCells;
+		size_t myMask;
+
+		alignas(64) std::atomic<size_t> myEnqueuePosition = 0;
+		alignas(64) size_t myDequeuePosition = 0;
+
+	public:
+		explicit VFXCommandQueue(size_t aCapacity = VFX_COMMAND_QUEUE_CAPACITY);
+
+		//any thread, fails instead of blocking when the queue is full
+		bool TryPush(const VFXCommand& aCommand);
+
+		//consumer thread only
+		bool TryPop(VFXCommand& anOutCommand);
+	};
+}
@@ -0,0 +1,264 @@
+#include "stdafx.h"
+#include "VFXCostAnalyzer.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	namespace
+	{
+		//the points are normalized, the evaluated value is remapped into the curve's range
+		float GetCurvePeak(const std::vector<Vector2f>& aPoints, float aMinValue, float aMaxValue)
+		{
+			float peak = 0.0f;
+			for (const Vector2f& point : aPoints) { peak = std::max(peak, std::abs(aMinValue + (aMaxValue - aMinValue) * point.y)); }
+			return peak;
+		}
+
+		int CountBursts(const VFXCostSource& aSource, int aFirstFrame, int aLastFrame)
+		{
+			if (aLastFrame < aFirstFrame) { return 0; }
+
+			const int interval = std::max(1, (int)(aSource.burstInterval * VFX_SEQUENCE_FRAME_RATE));
+			const int first = (aFirstFrame - aSource.startFrame + interval - 1) / interval;
+			const int last = (aLastFrame - aSource.startFrame) / interval;
+			return std::max(0, last - first + 1);
+		}
+	}
+
+	std::vector<VFXCostSource> GetVFXCostSources(VFXSequence& aSequence)
+	{
+		std::vector<VFXCostSource> sources;
+		sources.reserve(aSequence.myTimestamps.size());
+
+		for (const VFXTimeStamp& timestamp : aSequence.myTimestamps)
+		{
+			VFXCostSource& source = sources.emplace_back();
+			source.type = timestamp.myType;
+			source.startFrame = timestamp.myStartpoint;
+			source.endFrame = timestamp.myEndpoint;
+
+			if (timestamp.myType == VFXType::ParticleEmitter && timestamp.myEffectIndex < aSequence.myParticleEmitters.size())
+			{
+				ParticleEmitter& emitter = aSequence.myParticleEmitters[timestamp.myEffectIndex].myEmitter;
+				auto& attr = emitter.GetSharedAttributes();
+
+				source.particleCapacity = (int)emitter.GetSpriteBatch()->myInstances.size();
+				source.burstCount = (int)attr.burstCountMax;
+				source.burstInterval = attr.burstTimeMin;
+				source.lifeTime = attr.lifeTimeMax;
+				source.particleSize = std::max({ (float)attr.startSize, (float)attr.midSize, (float)attr.endSize });
+			}
+			else if (timestamp.myType == VFXType::VFXMeshInstance)
+			{
+				const VFXCurveDataSet& scaleX = timestamp.myCurveDataSets[(int)VFXAttributeTypes::SCALE_X];
+				const VFXCurveDataSet& scaleY = timestamp.myCurveDataSets[(int)VFXAttributeTypes::SCALE_Y];
+				const float x = scaleX.IsValid() && !scaleX.myData.empty() ? GetCurvePeak(scaleX.myData, scaleX.myMinValue, scaleX.myMaxValue) : 1.0f;
+				const float y = scaleY.IsValid() && !scaleY.myData.empty() ? GetCurvePeak(scaleY.myData, scaleY.myMinValue, scaleY.myMaxValue) : 1.0f;
+				source.meshArea = x * y;
+
+				if (timestamp.myEffectIndex < aSequence.myVFXMeshes.size())
+				{
+					source.meshPasses = aSequence.myVFXMeshes[timestamp.myEffectIndex].GetPasses().count;
+				}
+			}
+		}
+
+		return sources;
+	}
+
+	std::vector<VFXCostSource> GetVFXCostSources(const nlohmann::json& aSequence)
+	{
+		std::vector<VFXCostSource> sources;
+		if (!aSequence.contains("timestamps")) { return sources; }
+
+		const nlohmann::json& emitters = aSequence["particleEmitters"];
+		for (const auto& timestamp : aSequence["timestamps"])
+		{
+			VFXCostSource& source = sources.emplace_back();
+			source.type = (VFXType)timestamp["type"].get<int>();
+			source.startFrame = timestamp["start"];
+			source.endFrame = timestamp["end"];
+
+			const int effectIndex = timestamp["effectIndex"];
+			if (source.type == VFXType::ParticleEmitter && effectIndex < emitters.size())
+			{
+				const nlohmann::json& emitter = emitters[effectIndex];
+				const nlohmann::json& attr = emitter["sharedParticleAttributes"];
+
+				source.particleCapacity = emitter["particleCapacity"];
+				source.burstCount = (int)attr["burstCountMax"].get<float>();
+				source.burstInterval = attr["burstTimeMin"];
+				source.lifeTime = attr["lifeTimeMax"];
+				source.particleSize = std::max({ attr["startSize"].get<float>(), attr["midSize"].get<float>(), attr["endSize"].get<float>() });
+			}
+			else if (source.type == VFXType::VFXMeshInstance)
+			{
+				float scale[2] = { 1.0f, 1.0f };
+				for (const auto& curve : timestamp["curves"])
+				{
+					const int attribute = curve["curveAttribute"].get<int>() - (int)VFXAttributeTypes::SCALE_X;
+					if (attribute < 0 || attribute > 1 || curve["points"].empty()) { continue; }
+
+					std::vector<Vector2f> points;
+					for (const auto& point : curve["points"]) { points.push_back(Vector2f(point["x"], point["y"])); }
+					scale[attribute] = GetCurvePeak(points, curve["minValue"], curve["maxValue"]);
+				}
+				source.meshArea = scale[0] * scale[1];
+
+				//the shape is only known once the model is loaded, so auto is counted as two passes
+				const nlohmann::json& meshes = aSequence["meshes"];
+				if (effectIndex < meshes.size())
+				{
+					const VFXMeshDrawMode drawMode = (VFXMeshDrawMode)meshes[effectIndex].value("drawMode", (int)VFXMeshDrawMode::Auto);
+					source.meshPasses = GetVFXMeshPasses(VFXMeshShape::Closed, drawMode).count;
+				}
+			}
+		}
+
+		return sources;
+	}
+
+	void EstimateVFXCost(std::span<const VFXCostSource> aSources, int aDuration, VFXCostEstimate& anOutEstimate)
+	{
+		anOutEstimate.frames.assign(std::max(aDuration, 0), {});
+		anOutEstimate.peak = {};
+
+		for (const VFXCostSource& source : aSources)
+		{
+			if (source.type == VFXType::VFXMeshInstance)
+			{
+				for (int f = std::max(source.startFrame, 0); f <= source.endFrame && f < aDuration; f++)
+				{
+					VFXFrameCost& frame = anOutEstimate.frames[f];
+					frame.meshPackages++;
+					frame.drawCalls += source.meshPasses;
+					frame.screenCoverage += source.meshArea / VFX_COST_REFERENCE_VIEW_AREA;
+				}
+			}
+			else if (source.type == VFXType::ParticleEmitter)
+			{
+				//every burst that is still alive at a frame counts, emitters keep draining after their window closes
+				const int lifeFrames = (int)std::ceil(source.lifeTime * VFX_SEQUENCE_FRAME_RATE);
+				const float particleArea = source.particleSize * source.particleSize / VFX_COST_REFERENCE_VIEW_AREA;
+
+				for (int f = std::max(source.startFrame, 0); f <= source.endFrame + lifeFrames && f < aDuration; f++)
+				{
+					int particles = CountBursts(source, std::max(source.startFrame, f - lifeFrames), std::min(f, source.endFrame)) * source.burstCount;
+					if (source.particleCapacity > 0) { particles = std::min(particles, source.particleCapacity); }
+					if (particles == 0) { continue; }
+
+					VFXFrameCost& frame = anOutEstimate.frames[f];
+					frame.particles += particles;
+					frame.drawCalls++;
+					frame.screenCoverage += (float)particles * particleArea;
+				}
+			}
+		}
+
+		VFXFrameCost& peak = anOutEstimate.peak;
+		for (int f = 0; f < anOutEstimate.frames.size(); f++)
+		{
+			const VFXFrameCost& frame = anOutEstimate.frames[f];
+			if (frame.particles > peak.particles) { peak.particles = frame.particles; anOutEstimate.peakParticleFrame = f; }
+			if (frame.meshPackages > peak.meshPackages) { peak.meshPackages = frame.meshPackages; anOutEstimate.peakMeshFrame = f; }
+			if (frame.drawCalls > peak.drawCalls) { peak.drawCalls = frame.drawCalls; anOutEstimate.peakDrawFrame = f; }
+			if (frame.screenCoverage > peak.screenCoverage) { peak.screenCoverage = frame.screenCoverage; anOutEstimate.peakCoverageFrame = f; }
+		}
+	}
+
+	std::vector<std::string> GetVFXBudgetViolations(const VFXCostEstimate& anEstimate, const VFXBudget& aBudget)
+	{
+		std::vector<std::string> violations;
+		const VFXFrameCost& peak = anEstimate.peak;
+
+		if (peak.particles > aBudget.myMaxParticles)
+		{
+			violations.push_back(std::format("{} particles at frame {} (budget {})", peak.particles, anEstimate.peakParticleFrame, aBudget.myMaxParticles));
+		}
+		if (peak.meshPackages > aBudget.myMaxMeshPackages)
+		{
+			violations.push_back(std::format("{} meshes at frame {} (budget {})", peak.meshPackages, anEstimate.peakMeshFrame, aBudget.myMaxMeshPackages));
+		}
+		if (peak.drawCalls > aBudget.myMaxDrawCalls)
+		{
+			violations.push_back(std::format("{} draw calls at frame {} (budget {})", peak.drawCalls, anEstimate.peakDrawFrame, aBudget.myMaxDrawCalls));
+		}
+		if (peak.screenCoverage > aBudget.myMaxScreenCoverage)
+		{
+			violations.push_back(std::format("{:.2f} screen coverage at frame {} (budget {:.2f})", peak.screenCoverage, anEstimate.peakCoverageFrame, aBudget.myMaxScreenCoverage));
+		}
+
+		return violations;
+	}
+
+	nlohmann::json VFXBudgetToJson(const VFXBudget& aBudget)
+	{
+		nlohmann::json budget;
+		budget["maxParticles"] = aBudget.myMaxParticles;
+		budget["maxMeshPackages"] = aBudget.myMaxMeshPackages;
+		budget["maxDrawCalls"] = aBudget.myMaxDrawCalls;
+		budget["maxScreenCoverage"] = aBudget.myMaxScreenCoverage;
+		return budget;
+	}
+
+	VFXBudget VFXBudgetFromJson(const nlohmann::json& aBudget)
+	{
+		VFXBudget budget;
+		budget.myMaxParticles = aBudget.value("maxParticles", budget.myMaxParticles);
+		budget.myMaxMeshPackages = aBudget.value("maxMeshPackages", budget.myMaxMeshPackages);
+		budget.myMaxDrawCalls = aBudget.value("maxDrawCalls", budget.myMaxDrawCalls);
+		budget.myMaxScreenCoverage = aBudget.value("maxScreenCoverage", budget.myMaxScreenCoverage);
+		return budget;
+	}
+
+	bool ValidateVFXSequenceFile(const std::string& aFilePath)
+	{
+		std::ifstream file(aFilePath);
+		if (!file.is_open())
+		{
+			KE_ERROR("Failed to open VFX sequence %s", aFilePath.c_str());
+			return false;
+		}
+
+		nlohmann::json input = nlohmann::json::parse(file, nullptr, false);
+		if (input.is_discarded())
+		{
+			KE_ERROR("Failed to parse VFX sequence %s", aFilePath.c_str());
+			return false;
+		}
+
+		//sequences saved before budgets existed are checked against the defaults
+		const VFXBudget budget = input.contains("budget") ? VFXBudgetFromJson(input["budget"]) : VFXBudget{};
+
+		VFXCostEstimate estimate;
+		EstimateVFXCost(GetVFXCostSources(input), input.value("duration", 0), estimate);
+
+		const std::vector<std::string> violations = GetVFXBudgetViolations(estimate, budget);
+		for (const std::string& violation : violations)
+		{
+			KE_ERROR("VFX sequence %s is over budget: %s", aFilePath.c_str(), violation.c_str());
+		}
+		return violations.empty();
+	}
+
+	int ValidateVFXSequenceDirectory(const std::string& aDirectory)
+	{
+		int failing = 0;
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(aDirectory, error))
+		{
+			if (entry.path().extension() != ".kittyVFX") { continue; }
+			failing += ValidateVFXSequenceFile(entry.path().string()) ? 0 : 1;
+		}
+
+		if (error)
+		{
+			KE_ERROR("Failed to read VFX sequence directory %s", aDirectory.c_str());
+		}
+		return failing;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <span>
+#include <string>
+#include <vector>
+
+#include <External/Include/nlohmann/json.hpp>
+
+#include "Engine/Source/Graphics/FX/VFXResources.h"
+
+namespace KE
+{
+	constexpr float VFX_COST_REFERENCE_VIEW_AREA = 100.0f; //world units squared the screen covers at the reference distance
+
+	//everything the estimate needs from one timestamp, so it can be built from a loaded sequence or straight from a .kittyVFX file
+	struct VFXCostSource
+	{
+		VFXType type = VFXType::Count;
+		int startFrame = 0;
+		int endFrame = 0;
+
+		//particle emitters, worst case values
+		int particleCapacity = 0;
+		int burstCount = 0;
+		float burstInterval = 0.0f; //seconds, 0 bursts every frame
+		float lifeTime = 0.0f;
+		float particleSize = 0.0f;
+
+		//meshes, largest area the scale curves reach for a unit mesh
+		float meshArea = 1.0f;
+		int meshPasses = 2;
+	};
+
+	struct VFXFrameCost
+	{
+		int particles = 0;
+		int meshPackages = 0;
+		int drawCalls = 0;
+		float screenCoverage = 0.0f; //screens worth of overdraw at the reference distance
+	};
+
+	struct VFXCostEstimate
+	{
+		std::vector<VFXFrameCost> frames;
+
+		VFXFrameCost peak;
+		int peakParticleFrame = 0;
+		int peakMeshFrame = 0;
+		int peakDrawFrame = 0;
+		int peakCoverageFrame = 0;
+	};
+
+	std::vector<VFXCostSource> GetVFXCostSources(VFXSequence& aSequence);
+	std::vector<VFXCostSource> GetVFXCostSources(const nlohmann::json& aSequence);
+	void EstimateVFXCost(std::span<const VFXCostSource> aSources, int aDuration, VFXCostEstimate& anOutEstimate);
+
+	//one readable line per exceeded budget, empty when the sequence fits
+	std::vector<std::string> GetVFXBudgetViolations(const VFXCostEstimate& anEstimate, const VFXBudget& aBudget);
+
+	nlohmann::json VFXBudgetToJson(const VFXBudget& aBudget);
+	VFXBudget VFXBudgetFromJson(const nlohmann::json& aBudget);
+
+	//headless validation of saved sequences, doesn't touch any graphics resources
+	bool ValidateVFXSequenceFile(const std::string& aFilePath);
+	int ValidateVFXSequenceDirectory(const std::string& aDirectory = VFX_SEQUENCE_FILE_LOCATION); //returns the number of failing sequences
+}
@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "VFXCurveReduction.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	static bool FitsSegment(const std::vector<Vector2f>& someOriginal, int aFirst, int aLast, VFXCurveProfiles aProfile, float aTolerance)
+	{
+		const Vector2f& first = someOriginal[aFirst];
+		const Vector2f& last = someOriginal[aLast];
+
+		for (int segment = aFirst; segment < aLast; segment++)
+		{
+			const Vector2f& lower = someOriginal[segment];
+			const Vector2f& upper = someOriginal[segment + 1];
+
+			//points sharing a time are authored jumps, they're never merged away
+			if (upper.x <= lower.x) { return false; }
+
+			for (int sample = 0; sample < VFX_CURVE_REDUCTION_SAMPLES; sample++)
+			{
+				const float time = lower.x + (upper.x - lower.x) * (float)sample / (float)VFX_CURVE_REDUCTION_SAMPLES;
+				const float original = InterpolateVFXCurve(aProfile, lower, upper, time);
+				const float reduced = InterpolateVFXCurve(aProfile, first, last, time);
+
+				if (std::abs(reduced - original) > aTolerance) { return false; }
+			}
+		}
+		return true;
+	}
+
+	int ReduceVFXCurve(std::vector<Vector2f>& somePoints, VFXCurveProfiles aProfile, float aTolerance)
+	{
+		if (somePoints.size() <= 2) { return 0; }
+
+		const std::vector<Vector2f> original = somePoints;
+		somePoints.clear();
+		somePoints.push_back(original.front());
+
+		//greedy, every kept point is the last one the segment from the previous kept point could still reach
+		int anchor = 0;
+		for (int next = 2; next < original.size(); next++)
+		{
+			if (!FitsSegment(original, anchor, next, aProfile, aTolerance))
+			{
+				anchor = next - 1;
+				somePoints.push_back(original[anchor]);
+			}
+		}
+		somePoints.push_back(original.back());
+
+		return (int)(original.size() - somePoints.size());
+	}
+
+	int ReduceVFXCurve(VFXCurveDataSet& aCurve, float aTolerance)
+	{
+		return ReduceVFXCurve(aCurve.myData, aCurve.myCurveProfile, aTolerance);
+	}
+
+	VFXCurveReductionReport ReduceVFXSequenceCurves(VFXSequence& aSequence, float aTolerance)
+	{
+		VFXCurveReductionReport report;
+		const auto reduce = [&report, aTolerance](VFXCurveDataSet& aCurve)
+		{
+			if (!aCurve.IsValid()) { return; }
+
+			report.curves++;
+			report.pointsBefore += (int)aCurve.myData.size();
+			report.pointsRemoved += ReduceVFXCurve(aCurve, aTolerance);
+		};
+
+		for (VFXTimeStamp& timestamp : aSequence.myTimestamps)
+		{
+			std::ranges::for_each(timestamp.myCurveDataSets, reduce);
+			std::ranges::for_each(timestamp.myCustomCurveDataSets, reduce);
+		}
+		return report;
+	}
+
+	VFXCurveReductionReport ReduceVFXSequenceCurves(nlohmann::json& aSequence, float aTolerance)
+	{
+		VFXCurveReductionReport report;
+		if (!aSequence.contains("timestamps")) { return report; }
+
+		std::vector<Vector2f> points;
+		const auto reduceCurves = [&](nlohmann::json& someCurves)
+		{
+			for (auto& curve : someCurves)
+			{
+				points.clear();
+				for (auto& point : curve["points"])
+				{
+					points.push_back(Vector2f(point["x"], point["y"]));
+				}
+
+				report.curves++;
+				report.pointsBefore += (int)points.size();
+
+				const int removed = ReduceVFXCurve(points, (VFXCurveProfiles)curve["curveProfile"], aTolerance);
+				if (removed == 0) { continue; }
+
+				report.pointsRemoved += removed;
+				curve["points"] = nlohmann::json::array();
+				for (const Vector2f& point : points)
+				{
+					curve["points"].push_back({ { "x", point.x }, { "y", point.y } });
+				}
+			}
+		};
+
+		for (auto& timestamp : aSequence["timestamps"])
+		{
+			reduceCurves(timestamp["curves"]);
+
+			//older files don't have any custom attribute curves
+			if (timestamp.contains("customCurves")) { reduceCurves(timestamp["customCurves"]); }
+		}
+		return report;
+	}
+
+	bool CookVFXSequenceFile(const std::string& aSourcePath, const std::string& aCookedPath, VFXCurveReductionReport& outReport, float aTolerance)
+	{
+		std::ifstream source(aSourcePath);
+		nlohmann::json sequence = source.is_open() ? nlohmann::json::parse(source, nullptr, false) : nlohmann::json(nlohmann::json::value_t::discarded);
+		if (sequence.is_discarded())
+		{
+			KE_ERROR("Failed to read VFX sequence %s for cooking", aSourcePath.c_str());
+			return false;
+		}
+
+		outReport = ReduceVFXSequenceCurves(sequence, aTolerance);
+
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(aCookedPath).parent_path(), error);
+
+		std::ofstream cooked(aCookedPath, std::ios::binary | std::ios::trunc);
+		if (!cooked.is_open())
+		{
+			KE_ERROR("Failed to write cooked VFX sequence %s", aCookedPath.c_str());
+			return false;
+		}
+
+		cooked << sequence.dump();
+		return cooked.good();
+	}
+
+	VFXCurveReductionReport CookVFXSequenceDirectory(const std::string& aSourceDirectory, const std::string& aCookedDirectory, float aTolerance)
+	{
+		VFXCurveReductionReport total;
+		for (const auto& entry : std::filesystem::directory_iterator(aSourceDirectory))
+		{
+			if (entry.path().extension() != ".kittyVFX") { continue; }
+
+			VFXCurveReductionReport report;
+			const std::string cookedPath = (std::filesystem::path(aCookedDirectory) / entry.path().filename()).string();
+			if (!CookVFXSequenceFile(entry.path().string(), cookedPath, report, aTolerance)) { continue; }
+
+			total.curves += report.curves;
+			total.pointsBefore += report.pointsBefore;
+			total.pointsRemoved += report.pointsRemoved;
+		}
+		return total;
+	}
+}
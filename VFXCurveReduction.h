@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include <External/Include/nlohmann/json.hpp>
+
+#include "Engine/Source/Graphics/FX/VFXResources.h"
+
+namespace KE
+{
+	constexpr float VFX_CURVE_REDUCTION_TOLERANCE = 0.005f; //in curve space, before the curve's min and max are applied
+	constexpr int VFX_CURVE_REDUCTION_SAMPLES = 8; //checked per original segment on top of the original points
+
+	struct VFXCurveReductionReport
+	{
+		int curves = 0;
+		int pointsBefore = 0;
+		int pointsRemoved = 0;
+	};
+
+	//removes points as long as the curve still evaluates within the tolerance of the original everywhere between its endpoints.
+	//the endpoints are always kept since they define the curve's time range. returns the number of removed points
+	int ReduceVFXCurve(std::vector<Vector2f>& somePoints, VFXCurveProfiles aProfile, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+	int ReduceVFXCurve(VFXCurveDataSet& aCurve, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+
+	VFXCurveReductionReport ReduceVFXSequenceCurves(VFXSequence& aSequence, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+	VFXCurveReductionReport ReduceVFXSequenceCurves(nlohmann::json& aSequence, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+
+	//cooked sequences always have their curves reduced and are written without indentation
+	bool CookVFXSequenceFile(const std::string& aSourcePath, const std::string& aCookedPath, VFXCurveReductionReport& outReport, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+	VFXCurveReductionReport CookVFXSequenceDirectory(const std::string& aSourceDirectory, const std::string& aCookedDirectory, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+}
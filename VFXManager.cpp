@@ -2,6 +2,7 @@
 #include "Engine/Source/Graphics/ModelData.h"
 #include "Engine/Source/Graphics/Graphics.h"
 #include "VFXManager.h"
+#include "VFXCostAnalyzer.h"
 
 #include <External/Include/nlohmann/json.hpp>
 
@@ -47,524 +48,2181 @@ namespace KE
 		postProcessAttributes.bloomBlending = 0.2f;
 		postProcessAttributes.bloomTreshold = 0.25f;
 
+#ifdef KITTYENGINE_NO_EDITOR
+		//shipping builds load from the pack when one was built, the editor always works on the loose files
+		if (std::filesystem::exists(VFX_PACK_FILE_LOCATION))
+		{
+			MountVFXPack(VFX_PACK_FILE_LOCATION);
+		}
+#endif
+
 		KE_GLOBAL::blackboard.Register(this);
 	}
 
-	void VFXManager::RenderVFX(const VFXBufferData& aFxBuffer, const ModelData* aModelData)
+	//set on the middle snapshot index when update has put a frame there the render thread hasn't taken yet
+	static constexpr int VFX_SNAPSHOT_PUBLISHED = 1 << 2;
+	static constexpr int VFX_SNAPSHOT_INDEX_MASK = VFX_SNAPSHOT_PUBLISHED - 1;
+
+	static eRasterizerStates GetPassRasterizerState(VFXMeshPass aPass)
+	{
+		switch (aPass)
+		{
+		case VFXMeshPass::BackFaces:
+			return eRasterizerStates::FrontfaceCulling;
+		case VFXMeshPass::FrontFaces:
+			return eRasterizerStates::BackfaceCulling;
+		default:
+			return eRasterizerStates::NoCulling;
+		}
+	}
+
+	void VFXManager::RenderVFX(const VFXBufferData& aFxBuffer, const ModelData* aModelData, const VFXMeshPasses& aPasses)
 	{
+		KE_VFX_PROFILE_COUNTER_ADD(myProfiler, MeshDraws, aPasses.count);
+		KE_VFX_PROFILE_COUNTER_ADD(myProfiler, StateChanges, 1 + aPasses.count); //cbuffer map and a rasterizer state per pass
+
 		auto* graphicsContext = myGraphics->GetContext().Get();
 		myVFXCBuffer.MapBuffer(&aFxBuffer, sizeof(aFxBuffer), graphicsContext);
 		myVFXCBuffer.BindForPS(6, graphicsContext);
 		myVFXCBuffer.BindForVS(6, graphicsContext);
 
-		myGraphics->SetRasterizerState(KE::eRasterizerStates::FrontfaceCulling);
-		myVFXRenderer.RenderModel(
-			{
-				nullptr,
-				myGraphics->GetView(),
-				myGraphics->GetProjection(),
-				0,
-				0
-			},
-			*aModelData
-		);
-
-		myGraphics->SetRasterizerState(KE::eRasterizerStates::BackfaceCulling);
-		myVFXRenderer.RenderModel(
-			{
-				nullptr,
-				myGraphics->GetView(),
-				myGraphics->GetProjection(),
-				0,
-				0
-			},
-			*aModelData
-		);
+		for (int pass = 0; pass < aPasses.count; pass++)
+		{
+			myGraphics->SetRasterizerState(GetPassRasterizerState(aPasses.passes[pass]));
+			myVFXRenderer.RenderModel(
+				{
+					nullptr,
+					myGraphics->GetView(),
+					myGraphics->GetProjection(),
+					0,
+					0
+				},
+				*aModelData
+			);
+		}
 	}
 
-	void VFXManager::Render(eRenderLayers aLayer, ID3D11DepthStencilView* aDSV)
+	void VFXManager::Render(eRenderLayers aLayer, ID3D11DepthStencilView* aDSV, int aViewIndex)
 	{
+		VFXRenderSnapshot& snapshot = myRenderSnapshots[GetRenderSnapshotIndex()];
+		if (aViewIndex < 0 || aViewIndex >= snapshot.myViewSubmissions.size()) { return; }
+
+		VFXViewSubmission& submission = snapshot.myViewSubmissions[aViewIndex];
+		if (!submission.myCamera) { return; }
+
+		KE_VFX_PROFILE_SCOPE(myProfiler, "VFX Render");
+
 		myGraphics->SetDepthStencilState(KE::eDepthStencilStates::ReadOnlyLess);
 		myGraphics->SetBlendState(KE::eBlendStates::VFXBlend);
 
-		for (auto& playedVFX: myRenderQueue)
 		{
-			for (auto& emitter : playedVFX.myEmitters)
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Sprite Batches");
+			for (VFXSpriteBatchGroup& group : snapshot.mySpriteBatchGroups)
 			{
-				auto* batch = emitter.myEmitter.GetSpriteBatch();
-				mySpriteManager->BindBuffers(*batch, myGraphics->GetCameraManager().GetHighlightedCamera());
-				mySpriteManager->RenderBatch(*batch);
+				if (group.myLayer != aLayer) { continue; }
+
+				mySpriteManager->BindBuffers(group.myBatch, &*submission.myCamera);
+				mySpriteManager->RenderBatch(group.myBatch);
+
+				KE_VFX_PROFILE_COUNTER_ADD(myProfiler, SpriteDraws, 1);
+				KE_VFX_PROFILE_COUNTER_ADD(myProfiler, StateChanges, 1);
 			}
 		}
 
-		for (VFXSequenceRenderPackage& package : myRenderPackages)
 		{
-			if (package.layer != aLayer) { continue; }
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Mesh Packages");
+			for (const int packageIndex : submission.myPackageIndices)
+			{
+				RenderPackage(snapshot.myRenderPackages[packageIndex], aLayer);
+			}
+
+			//packages added after the views were built (RenderVFXDirect) aren't in any view's list yet
+			for (size_t i = snapshot.mySubmittedPackageCount; i < snapshot.myRenderPackages.size(); i++)
+			{
+				RenderPackage(snapshot.myRenderPackages[i], aLayer);
+			}
+		}
+
+		myGraphics->SetDepthStencilState(KE::eDepthStencilStates::Write);
+		myGraphics->SetBlendState(KE::eBlendStates::Disabled);
+	}
+	
+	void VFXManager::RenderPackage(VFXSequenceRenderPackage& aPackage, eRenderLayers aLayer)
+	{
+		if (aPackage.layer != aLayer) { return; }
 
-			VFXBufferData fxb{};
+		VFXBufferData fxb{};
 
-			fxb.colour = package.attributes.colour;
-			fxb.uvOffset = package.attributes.uvOffset;
-			fxb.uvScale = package.attributes.uvScale;
+		fxb.colour = aPackage.attributes.colour;
+		fxb.uvOffset = aPackage.attributes.uvOffset;
+		fxb.uvScale = aPackage.attributes.uvScale;
 
-			fxb.bloomAttributes = {
-				package.bloom ? 1.0f : 0.0f,
-				0.0f,
-				0.0f,
-				0.0f
-			};
+		fxb.bloomAttributes = {
+			aPackage.bloom ? 1.0f : 0.0f,
+			0.0f,
+			0.0f,
+			0.0f
+		};
+		std::memcpy(fxb.customAttributes, aPackage.attributes.custom.data(), sizeof(fxb.customAttributes));
 
-			auto* modelData = package.modelData;
-			modelData->myTransform = &package.instanceTransform.GetMatrix();
+		auto* modelData = aPackage.modelData;
+		modelData->myTransform = &aPackage.instanceTransform.GetMatrix();
 
-			if (package.customBuffer.constantBuffer != nullptr)
-			{
-				const auto& buffer = package.customBuffer;
-				buffer.constantBuffer->MapBuffer(buffer.bufferData, buffer.bufferSize, myGraphics->GetContext().Get());
-				buffer.constantBuffer->BindForPS(buffer.bufferSlot, myGraphics->GetContext().Get());
-			}
+		if (aPackage.customBuffer.constantBuffer != nullptr)
+		{
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Custom CBuffer Map");
+			KE_VFX_PROFILE_COUNTER_ADD(myProfiler, StateChanges, 1);
 
-			RenderVFX(fxb, modelData);
+			const auto& buffer = aPackage.customBuffer;
+			buffer.constantBuffer->MapBuffer(buffer.bufferData, buffer.bufferSize, myGraphics->GetContext().Get());
+			buffer.constantBuffer->BindForPS(buffer.bufferSlot, myGraphics->GetContext().Get());
 		}
 
-		myGraphics->SetDepthStencilState(KE::eDepthStencilStates::Write);
-		myGraphics->SetBlendState(KE::eBlendStates::Disabled);
+		RenderVFX(fxb, modelData, aPackage.passes);
 	}
 	
 	void VFXManager::Update(float aDeltaTime)
 	{
-		for (int i = 0; i < myRenderQueue.size(); i++)
+#ifdef KE_VFX_PROFILING
+		myProfiler.BeginFrame();
+#endif
+		KE_VFX_PROFILE_SCOPE(myProfiler, "VFX Update");
+
+		if (myParticleAtlasDirty)
+		{
+			BuildParticleAtlas();
+		}
+
+		ExecuteQueuedCommands();
+		GatherFrameViews();
+
+		if (myIsHotReloadEnabled)
+		{
+			PollHotReload(aDeltaTime);
+		}
+
+		if (myTraceRecorder)
 		{
-			VFXSequencePlayerData& playerData = myRenderQueue[i];
-			playerData.myTimer += aDeltaTime * VFX_SEQUENCE_FRAME_RATE;
-			if (playerData.myTimer > myVFXSequences[playerData.mySequenceIndex].myDuration)
+			myTraceRecorder->RecordFrameBegin(aDeltaTime, myFrameViews);
+			for (auto& playerData : myRenderQueue)
 			{
-				if (playerData.myIsLooping)
-				{
-					playerData.myTimer = 0.0f;
-				}
-				else
+				if (!playerData.myRenderInput.isStationary) { myTraceRecorder->RecordAttachedTransform(playerData.myRenderInput.myTransform); }
+			}
+		}
+
+		{
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Advance Timers");
+			for (int i = 0; i < myRenderQueue.size(); i++)
+			{
+				if (!AdvancePlayer(myRenderQueue[i], aDeltaTime))
 				{
 					myRenderQueue.erase(myRenderQueue.begin() + i);
 					i--;
 				}
 			}
-			playerData.myFrame = (int)(playerData.myTimer);
-			for (auto& emitter : playerData.myEmitters)
+
+			for (auto& sharedSimulation : mySharedSimulations)
 			{
-				emitter.myEmitter.Update(
-					*playerData.myRenderInput.myTransform, 
-					playerData.myFrame >= emitter.myStartFrame && playerData.myFrame <= emitter.myEndFrame
-				);
+				AdvancePlayer(sharedSimulation.myPlayerData, aDeltaTime);
 			}
 		}
 
-		for (auto& playerData : myRenderQueue)
-		{
-			PrepareRenderData(playerData);
-		}
-
-		Vector3f cameraPos = myGraphics->GetCameraManager().GetHighlightedCamera()->transform.GetPosition();
-		std::ranges::sort(myRenderPackages, [&cameraPos](const VFXSequenceRenderPackage& a, const VFXSequenceRenderPackage& b)
 		{
-			const float distA = (a.instanceTransform.GetPosition() - cameraPos).LengthSqr();
-			const float distB = (b.instanceTransform.GetPosition() - cameraPos).LengthSqr();
-			return distA > distB;
-		});
-	}
-
-	void VFXManager::Resize(int aWidth, int aHeight)
-	{
-		myVFXPostProcessing.ConfigureDownSampleRTs(myGraphics, aWidth, aHeight);
-	}
-
-	void VFXManager::EndFrame()
-	{
-		myRenderPackages.clear();
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Update Emitters");
+			for (auto& playerData : myRenderQueue)
+			{
+#ifdef KE_VFX_PROFILING
+				VFXSequenceCostScope cost(myProfiler, playerData.mySequenceIndex);
+#endif
+				UpdateLODLevel(playerData, GetClosestViewDistance(playerData.myRenderInput.GetTransform().GetPosition()));
+				UpdateEmitters(playerData);
+#ifdef KE_VFX_PROFILING
+				AddEmitterCost(cost.GetSample(), playerData, 1);
+#endif
+			}
 
-	}
+			for (auto& sharedSimulation : mySharedSimulations)
+			{
+#ifdef KE_VFX_PROFILING
+				VFXSequenceCostScope cost(myProfiler, sharedSimulation.myPlayerData.mySequenceIndex);
+#endif
+				float closestPlacement = FLT_MAX;
+				for (auto& placement : sharedSimulation.myPlacements)
+				{
+					closestPlacement = std::min(closestPlacement, GetClosestViewDistance(placement.myRenderInput.GetTransform().GetPosition()));
+				}
+				UpdateLODLevel(sharedSimulation.myPlayerData, closestPlacement);
+				UpdateEmitters(sharedSimulation.myPlayerData);
+#ifdef KE_VFX_PROFILING
+				AddEmitterCost(cost.GetSample(), sharedSimulation.myPlayerData, (int)sharedSimulation.myPlacements.size());
+#endif
+			}
+		}
 
-	void VFXManager::PrepareRenderData(VFXSequencePlayerData& aPlayerData)
-	{
-		KE::VFXSequence& sq = myVFXSequences[aPlayerData.mySequenceIndex];
-		for (int ts = 0; ts < sq.myTimestamps.size(); ts++)
 		{
-			VFXTimeStamp& vfxTS = sq.myTimestamps[ts];
-			if (vfxTS.myStartpoint > aPlayerData.myFrame || vfxTS.myEndpoint < aPlayerData.myFrame)
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Prepare Render Data");
+#ifdef KE_VFX_PROFILING
+			const auto& packages = myRenderSnapshots[myWriteSnapshot].myRenderPackages;
+#endif
+			for (auto& playerData : myRenderQueue)
 			{
-				continue;
+#ifdef KE_VFX_PROFILING
+				VFXSequenceCostScope cost(myProfiler, playerData.mySequenceIndex);
+				const size_t firstPackage = packages.size();
+#endif
+				PrepareRenderData(playerData);
+#ifdef KE_VFX_PROFILING
+				AddPackageCost(cost.GetSample(), std::span(packages).subspan(firstPackage));
+#endif
 			}
-			if (vfxTS.myType == VFXType::VFXMeshInstance)
-			{
-
-				VFXSequenceRenderPackage& renderPackage = myRenderPackages.emplace_back();
-
-				renderPackage.layer = aPlayerData.myLayer;
-				renderPackage.modelData = sq.myVFXMeshes[vfxTS.myEffectIndex].GetModelData();
-
-				renderPackage.bloom = aPlayerData.myRenderInput.bloom;
 
-				renderPackage.instanceTransform = aPlayerData.myRenderInput.GetTransform() * sq.myVFXMeshes[vfxTS.myEffectIndex].myTransform;
+			for (auto& sharedSimulation : mySharedSimulations)
+			{
+#ifdef KE_VFX_PROFILING
+				VFXSequenceCostScope cost(myProfiler, sharedSimulation.myPlayerData.mySequenceIndex);
+				const size_t firstPackage = packages.size();
+#endif
+				PrepareSharedRenderData(sharedSimulation);
+#ifdef KE_VFX_PROFILING
+				AddPackageCost(cost.GetSample(), std::span(packages).subspan(firstPackage));
+#endif
+			}
+		}
 
-				for (auto& modifier : vfxTS.myCurveDataSets)
-				{
-					if (!modifier.IsValid()) { continue; }
-					const float mod = modifier.GetEvaluatedValue(aPlayerData.myFrame, vfxTS.myStartpoint, vfxTS.myEndpoint);
-					float* base = (float*)&renderPackage.attributes;
-					base += (int)modifier.myType;
-					*base = mod;
-				}
+		{
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Build Sprite Batches");
+			BuildSpriteBatchGroups();
+		}
 
+		{
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Sort Views");
+			GatherBloomContributors();
+			BuildViewSubmissions();
+		}
 
-				Vector3f scl = renderPackage.instanceTransform.GetScale();
-				if (aPlayerData.myRenderInput.scaleOverride.x > -1.0f)
-				{
-					scl = aPlayerData.myRenderInput.scaleOverride;
-				}
+		{
+			KE_VFX_PROFILE_SCOPE(myProfiler, "Residency");
+			UpdateResidency();
+		}
 
-				Vector3f rot = {
-					KE::DegToRad(renderPackage.attributes.rotation.x),
-					KE::DegToRad(renderPackage.attributes.rotation.y),
-					KE::DegToRad(renderPackage.attributes.rotation.z)
-				};
+		if (myTraceRecorder)
+		{
+			myTraceRecorder->RecordFrameEnd(myRenderSnapshots[myWriteSnapshot].myRenderPackages);
+		}
 
-				renderPackage.instanceTransform.TranslateLocal(renderPackage.attributes.translation);
+		KE_VFX_PROFILE_COUNTER_SET(myProfiler, LivePlayers, myRenderQueue.size());
+		KE_VFX_PROFILE_COUNTER_SET(myProfiler, RenderPackages, myRenderSnapshots[myWriteSnapshot].myRenderPackages.size());
+#ifdef KE_VFX_PROFILING
+		size_t sharedPlacements = 0;
+		for (const auto& sharedSimulation : mySharedSimulations) { sharedPlacements += sharedSimulation.myPlacements.size(); }
+		KE_VFX_PROFILE_COUNTER_SET(myProfiler, SharedPlacements, sharedPlacements);
 
-				DirectX::XMMATRIX rotationMatrix = DirectX::XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z);
-				renderPackage.instanceTransform = rotationMatrix * renderPackage.instanceTransform.GetMatrix();
+		//the groups only hold live particles, one copy per placement, which is what gets drawn
+		size_t particles = 0;
+		for (const auto& group : myRenderSnapshots[myWriteSnapshot].mySpriteBatchGroups) { particles += group.myBatch.myInstances.size(); }
+		KE_VFX_PROFILE_COUNTER_SET(myProfiler, Particles, particles);
 
-				renderPackage.instanceTransform.SetScale({
-					scl.x * renderPackage.attributes.scale.x,
-					scl.y * renderPackage.attributes.scale.y,
-					scl.z * renderPackage.attributes.scale.z
-					});
+		UpdateMemoryStats();
+#endif
+	}
 
-				renderPackage.customBuffer = aPlayerData.myRenderInput.customBufferInput;
-			}
+#ifdef KE_VFX_PROFILING
+	void VFXManager::AddEmitterCost(VFXSequenceCostSample& aSample, VFXSequencePlayerData& aPlayerData, int aPlacementCount)
+	{
+		//every placement pays for its own copy of the emitter batches, same as BuildSpriteBatchGroups
+		aSample.instances += aPlacementCount;
+		for (auto& emitter : aPlayerData.myEmitters)
+		{
+			aSample.draws += aPlacementCount;
+			aSample.particles += (int64_t)GetVFXLiveParticleCount(*emitter.myEmitter.GetSpriteBatch()) * aPlacementCount;
 		}
 	}
 
-	void VFXManager::InitializeVFXMesh(VFXMeshInstance& aMeshToInitialize) const
+	void VFXManager::AddPackageCost(VFXSequenceCostSample& aSample, std::span<const VFXSequenceRenderPackage> somePackages)
 	{
-		ModelData& modelData = *aMeshToInitialize.GetModelData();
-		modelData.myTransform = &aMeshToInitialize.GetTransform()->GetMatrix();
-		modelData.myMeshList = &myGraphics->GetModelLoader().Load("Data/InternalAssets/cylinder.fbx");
-		auto& rr = modelData.myRenderResources.emplace_back();
-		rr.myMaterial = myGraphics->GetTextureLoader().GetDefaultMaterial();
-		rr.myPixelShader = myGraphics->GetShaderLoader().GetPixelShader(SHADER_LOAD_PATH "Model_VFX_PS.cso");
-		rr.myVertexShader = myGraphics->GetShaderLoader().GetVertexShader(SHADER_LOAD_PATH "Model_VFX_VS.cso");
+		aSample.packages += somePackages.size();
+		for (const VFXSequenceRenderPackage& package : somePackages)
+		{
+			aSample.draws += package.passes.count;
+		}
 	}
 
-	void VFXManager::InitializeParticleEmitter(ParticleEmitter& anEmitterToInitialize) const
+	std::vector<VFXSequenceCost> VFXManager::GetSequenceCosts(int aTopCount) const
 	{
-		anEmitterToInitialize.Init(myGraphics, 1024, "Data/InternalAssets/defaultTexture.png");
+		std::vector<VFXSequenceCost> costs = myProfiler.GetSequenceCosts();
+		std::ranges::sort(costs, [](const VFXSequenceCost& a, const VFXSequenceCost& b) { return a.cpuMicroseconds > b.cpuMicroseconds; });
+
+		if (aTopCount >= 0 && costs.size() > aTopCount)
+		{
+			costs.resize(aTopCount);
+		}
+		return costs;
 	}
+#endif
 
-	void VFXManager::TriggerVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput)
+	void VFXManager::GatherFrameViews()
 	{
-		VFXSequencePlayerData& sqData = myRenderQueue.emplace_back(aRenderInput);
-		sqData.mySequenceIndex = aVFXSequenceIndex;
-		sqData.myRenderInput = aRenderInput;
-		sqData.myTimer = 0.0f;
-		sqData.myIsLooping = aRenderInput.looping;
-		sqData.myLayer = aRenderInput.myLayer;
-
-		sqData.myTimestampTriggerInfo.resize(
-			myVFXSequences[aVFXSequenceIndex].myTimestamps.size(),
-			false
-		);
+		myFrameViews.assign(myViews.begin(), myViews.end());
+
+		//without any registered views we behave like before and draw for the highlighted camera
+		if (std::ranges::none_of(myFrameViews, [](const VFXView& aView) { return aView.myCamera != nullptr; }))
+		{
+			myFrameViews.assign(1, { myGraphics->GetCameraManager().GetHighlightedCamera() });
+		}
 
-		const size_t emitterCount = myVFXSequences[aVFXSequenceIndex].myParticleEmitters.size();
-		sqData.myEmitters.reserve(emitterCount);
-		for (int i = 0; i < emitterCount; ++i)
+		for (int i = 0; i < myFrameViews.size(); i++)
 		{
-			sqData.myEmitters.push_back(myVFXSequences[aVFXSequenceIndex].myParticleEmitters[i]);
+			VFXView& view = myFrameViews[i];
+			if (!view.myCamera) { continue; }
+			view.myPosition = i < myViewPositionOverrides.size() ? myViewPositionOverrides[i] : view.myCamera->transform.GetPosition();
 		}
 	}
 
-	void VFXManager::StopVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput)
+	float VFXManager::GetClosestViewDistance(const Vector3f& aPosition) const
 	{
-		//this is stupid but fuck it, we look for a playerData with the same index and transform pointer
-		for (int i = 0; i < myRenderQueue.size(); i++)
+		float closestDistance = FLT_MAX;
+		for (const VFXView& view : myFrameViews)
 		{
-			if (myRenderQueue[i].mySequenceIndex == aVFXSequenceIndex &&
-				myRenderQueue[i].myRenderInput.myTransform == aRenderInput.myTransform)
-			{
-				myRenderQueue.erase(myRenderQueue.begin() + i);
-				i--;
-			}
+			if (!view.myCamera) { continue; }
+			closestDistance = std::min(closestDistance, (aPosition - view.myPosition).Length());
 		}
+		return closestDistance;
 	}
 
-	void VFXManager::SaveVFXSequence(VFXSequence* aSequence)
+	void VFXManager::BuildViewSubmissions()
 	{
-		nlohmann::json output;
-		VFXSequence& sq = *aSequence;
-		
-		output["name"] = sq.myName;
-		output["duration"] = sq.myDuration;
-		
-		output["meshes"] = nlohmann::json::array();
-		output["particleEmitters"] = nlohmann::json::array();
-		output["timestamps"] = nlohmann::json::array();
-
-		for (auto& VFXMesh : sq.myVFXMeshes)
-		{
-			nlohmann::json mesh;
-			mesh["name"]	 = VFXMesh.myModelData.myMeshList->myFilePath;
+		//packages are shared between views, every view only gets its own culled and sorted list of indices into them
+		VFXRenderSnapshot& snapshot = myRenderSnapshots[myWriteSnapshot];
+		const auto& packages = snapshot.myRenderPackages;
 
-			mesh["albedo"]   = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[0]->myMetadata.myFilePath;
-			mesh["normal"]   = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[1]->myMetadata.myFilePath;
-			mesh["material"] = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[2]->myMetadata.myFilePath;
-			mesh["effects"]  = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[3]->myMetadata.myFilePath;
+		snapshot.myViewSubmissions.resize(myFrameViews.size());
+		snapshot.mySubmittedPackageCount = packages.size();
+		myViewSortKeys.resize(packages.size());
 
-			mesh["vertexShader"] = VFXMesh.myModelData.myRenderResources[0].myVertexShader->GetName();
-			mesh["pixelShader"] = VFXMesh.myModelData.myRenderResources[0].myPixelShader->GetName();
+		for (int v = 0; v < myFrameViews.size(); v++)
+		{
+			const VFXView& view = myFrameViews[v];
+			VFXViewSubmission& submission = snapshot.myViewSubmissions[v];
+			submission.myCamera.reset();
+			submission.myPackageIndices.clear();
 
-			output["meshes"].push_back(mesh);
-		}
+			if (!view.myCamera) { continue; }
+			submission.myCamera = *view.myCamera;
 
-		for (auto& emitter : sq.myParticleEmitters)
-		{
-			nlohmann::json em;
-			em["particleCapacity"] = emitter.myEmitter.GetSpriteBatch()->myInstances.size();
-			em["particleTexture"] = emitter.myEmitter.GetSpriteBatch()->myData.myTexture->myMetadata.myFilePath;
-			em["particleMode"] = (int)emitter.myEmitter.GetSpriteBatch()->myData.myMode;
+			const Vector3f cameraPos = view.myPosition;
+			const float cullDistanceSqr = view.myCullDistance * view.myCullDistance;
 
-			nlohmann::json spa;
-			auto& attr = emitter.myEmitter.GetSharedAttributes();
+			for (int i = 0; i < packages.size(); i++)
+			{
+				const float distSqr = (packages[i].instanceTransform.GetPosition() - cameraPos).LengthSqr();
+				if (distSqr > cullDistanceSqr) { continue; }
 
-			//
-			spa["burstTimeMin"] = attr.burstTimeMin;
-			spa["burstTimeMax"] = attr.burstTimeMax;
-			spa["burstCountMin"] = attr.burstCountMin;
-			spa["burstCountMax"] = attr.burstCountMax;
+				myViewSortKeys[i] = distSqr;
+				submission.myPackageIndices.push_back(i);
+			}
 
-			spa["velocityMin"] = attr.velocityMin;
-			spa["velocityMax"] = attr.velocityMax;
+			std::ranges::sort(submission.myPackageIndices, [this](int a, int b)
+			{
+				return myViewSortKeys[a] > myViewSortKeys[b];
+			});
 
-			spa["accelerationMin"] = attr.accelerationMin;
-			spa["accelerationMax"] = attr.accelerationMax;
+			submission.myBloomRect = {};
+			if (!snapshot.myBloomContributors.empty())
+			{
+				const DirectX::XMMATRIX viewProjection = submission.myCamera->GetViewMatrix() * submission.myCamera->GetProjectionMatrix();
+				submission.myBloomRect = GetVFXBloomRect(snapshot.myBloomContributors, viewProjection, myGraphics->GetRenderWidth(), myGraphics->GetRenderHeight());
+			}
+		}
+	}
 
-			spa["velocityDegradation"] = attr.velocityDegradation;
-			spa["accelerationDegradation"] = attr.accelerationDegradation;
+	static bool GetSpriteBatchBounds(SpriteBatch& aBatch, VFXBloomContributor& outBounds)
+	{
+		//dead slots sit wherever their particle died, only the live ones are bounded
+		bool hasLiveParticles = false;
+		Vector3f minimum = { FLT_MAX, FLT_MAX, FLT_MAX };
+		Vector3f maximum = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		float particleRadius = 0.0f;
+		for (auto& instance : aBatch.myInstances)
+		{
+			if (!IsVFXParticleAlive(instance)) { continue; }
+			hasLiveParticles = true;
 
-			spa["lifeTimeMin"] = attr.lifeTimeMin;
-			spa["lifeTimeMax"] = attr.lifeTimeMax;
-			spa["lifeTimeMidPoint"] = attr.lifeTimeMidPoint;
+			const Vector3f position = instance.myTransform.GetPosition();
+			const Vector3f scale = instance.myTransform.GetScale();
 
-			spa["angleMin"] = attr.angleMin;
-			spa["angleMax"] = attr.angleMax;
+			minimum = { std::min(minimum.x, position.x), std::min(minimum.y, position.y), std::min(minimum.z, position.z) };
+			maximum = { std::max(maximum.x, position.x), std::max(maximum.y, position.y), std::max(maximum.z, position.z) };
+			particleRadius = std::max({ particleRadius, std::abs(scale.x), std::abs(scale.y) });
+		}
+		if (!hasLiveParticles) { return false; }
 
-			spa["horizontalVelocityFactor"] = attr.horizontalVelocityFactor;
-			spa["verticalVelocityFactor"] = attr.verticalVelocityFactor;
+		outBounds.center = (minimum + maximum) * 0.5f;
+		outBounds.radius = (maximum - minimum).Length() * 0.5f + particleRadius;
+		return true;
+	}
 
-			spa["startColor"] = { attr.startColor.x, attr.startColor.y, attr.startColor.z, attr.startColor.w };
-			spa["midColor"] = { attr.midColor.x, attr.midColor.y, attr.midColor.z, attr.midColor.w };
-			spa["endColor"] = { attr.endColor.x, attr.endColor.y, attr.endColor.z, attr.endColor.w };
+	void VFXManager::GatherBloomContributors()
+	{
+		//bounding spheres of everything that writes into the bloom target, views turn them into their scissor rect
+		VFXRenderSnapshot& snapshot = myRenderSnapshots[myWriteSnapshot];
+		auto& contributors = snapshot.myBloomContributors;
+		contributors.clear();
 
-			spa["startSize"] = attr.startSize;
-			spa["midSize"] = attr.midSize;
-			spa["endSize"] = attr.endSize;
+		for (VFXSequenceRenderPackage& package : snapshot.myRenderPackages)
+		{
+			if (!package.bloom) { continue; }
 
-			//
+			const Vector3f scale = package.instanceTransform.GetScale();
+			contributors.push_back({ package.instanceTransform.GetPosition(), VFX_BLOOM_MESH_RADIUS * std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) }) });
+		}
 
-			em["sharedParticleAttributes"] = spa;
+		VFXBloomContributor bounds;
+		for (auto& playerData : myRenderQueue)
+		{
+			if (!playerData.myRenderInput.bloom) { continue; }
 
-			output["particleEmitters"].push_back(em);
+			for (auto& emitter : playerData.myEmitters)
+			{
+				if (GetSpriteBatchBounds(*emitter.myEmitter.GetSpriteBatch(), bounds)) { contributors.push_back(bounds); }
+			}
 		}
 
-		for (auto& timestamp : sq.myTimestamps)
+		//shared emitters simulate around the origin, their bounds get moved to every blooming placement
+		for (auto& sharedSimulation : mySharedSimulations)
 		{
-			nlohmann::json ts;
-			ts["type"] = (int)timestamp.myType;
-			ts["start"] = timestamp.myStartpoint;
-			ts["end"] = timestamp.myEndpoint;
-			ts["effectIndex"] = timestamp.myEffectIndex;
-			
-			ts["curves"] = nlohmann::json::array();
-			for (VFXCurveDataSet& curve : timestamp.myCurveDataSets)
+			for (auto& emitter : sharedSimulation.myPlayerData.myEmitters)
 			{
-				nlohmann::json cd;
-				cd["curveAttribute"] = (int)curve.myType;
-				cd["curveProfile"] = (int)curve.myCurveProfile;
-				cd["minValue"] = curve.myMinValue;
-				cd["maxValue"] = curve.myMaxValue;
-				cd["points"] = nlohmann::json::array();
-				
-				for (Vector2f& point : curve.myData)
+				if (!GetSpriteBatchBounds(*emitter.myEmitter.GetSpriteBatch(), bounds)) { continue; }
+
+				for (auto& placement : sharedSimulation.myPlacements)
 				{
-					nlohmann::json p;
-					p["x"] = point.x;
-					p["y"] = point.y;
-					cd["points"].push_back(p);
+					if (!placement.myRenderInput.bloom) { continue; }
+
+					Transform& transform = placement.myRenderInput.GetTransform();
+					const Vector3f scale = transform.GetScale();
+					DirectX::XMFLOAT3 center;
+					DirectX::XMStoreFloat3(&center, DirectX::XMVector3Transform(DirectX::XMVectorSet(bounds.center.x, bounds.center.y, bounds.center.z, 1.0f), transform.GetMatrix()));
+
+					contributors.push_back({ { center.x, center.y, center.z }, bounds.radius * std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) }) });
 				}
-				
-				ts["curves"].push_back(cd);
 			}
-			output["timestamps"].push_back(ts);
 		}
-		
-		std::string jsonStr = output.dump(4);
+	}
+
+	bool VFXManager::ShouldRunBloom(int aViewIndex) const
+	{
+		const VFXRenderSnapshot& snapshot = myRenderSnapshots[GetRenderSnapshotIndex()];
+		if (aViewIndex < 0 || aViewIndex >= snapshot.myViewSubmissions.size()) { return false; }
+
+		return !snapshot.myViewSubmissions[aViewIndex].myBloomRect.IsEmpty();
+	}
+
+	VFXScreenRect VFXManager::GetBloomScissorRect(int aViewIndex) const
+	{
+		const VFXRenderSnapshot& snapshot = myRenderSnapshots[GetRenderSnapshotIndex()];
+		if (aViewIndex < 0 || aViewIndex >= snapshot.myViewSubmissions.size()) { return {}; }
 
-		std::string out = VFX_SEQUENCE_FILE_LOCATION + sq.myName + ".kittyVFX";
-		std::ofstream file(out);
+		return snapshot.myViewSubmissions[aViewIndex].myBloomRect;
+	}
 
-		if (!file.is_open())
+	int VFXManager::RegisterView(Camera* aCamera, float aCullDistance)
+	{
+		for (int i = 0; i < myViews.size(); i++)
 		{
-			KE_ERROR("Failed to save sequence %s (%i)", sq.myName.c_str(), sq.myIndex);
-			int i = 0;
-			for (i = 0; i < 128 && !file.is_open(); i++)
+			if (!myViews[i].myCamera)
 			{
-				out = VFX_SEQUENCE_FILE_LOCATION + sq.myName + std::format("backupSave_{}.kittyVFX", i);
-				file.open(out);
+				myViews[i] = { aCamera, aCullDistance };
+				return i;
 			}
 		}
 
-		file << jsonStr;
-		file.close();
+		myViews.push_back({ aCamera, aCullDistance });
+		return (int)myViews.size() - 1;
 	}
 
-	void VFXManager::LoadVFXSequence(int aVFXSequenceIndex, const std::string& aFilePath)
+	void VFXManager::UnregisterView(int aViewIndex)
 	{
-		VFXSequence& sq = myVFXSequences[aVFXSequenceIndex];
+		if (aViewIndex < 0 || aViewIndex >= myViews.size()) { return; }
+		myViews[aViewIndex].myCamera = nullptr;
+	}
 
+	bool VFXManager::AdvancePlayer(VFXSequencePlayerData& aPlayerData, float aDeltaTime) const
+	{
+		aPlayerData.myTimer += aDeltaTime * VFX_SEQUENCE_FRAME_RATE;
+		if (aPlayerData.myTimer > myVFXSequences[aPlayerData.mySequenceIndex].myDuration)
+		{
+			if (!aPlayerData.myIsLooping)
+			{
+				return false;
+			}
+			aPlayerData.myTimer = 0.0f;
+		}
+		aPlayerData.myFrame = (int)(aPlayerData.myTimer);
+		return true;
+	}
+
+	void VFXManager::UpdateLODLevel(VFXSequencePlayerData& aPlayerData, float aCameraDistance)
+	{
+		const VFXSequence& sq = myVFXSequences[aPlayerData.mySequenceIndex];
+		if (sq.myLODLevels.empty()) { return; }
+
+		const int lodLevel = sq.SelectLODLevel(aCameraDistance, aPlayerData.myLODLevel);
+		if (lodLevel != aPlayerData.myLODLevel)
+		{
+			ApplyLODLevel(aPlayerData, lodLevel);
+		}
+	}
+
+	void VFXManager::UpdateEmitterResidency(VFXSequencePlayerData& aPlayerData)
+	{
+		//emitter copies only exist from shortly before their window opens until their particles have drained after it closes
+		VFXSequence& sq = myVFXSequences[aPlayerData.mySequenceIndex];
+		const int frame = aPlayerData.myFrame;
+
+		for (int ts = 0; ts < sq.myTimestamps.size(); ts++)
+		{
+			const VFXTimeStamp& vfxTS = sq.myTimestamps[ts];
+			if (vfxTS.myType != VFXType::ParticleEmitter || vfxTS.myEffectIndex >= sq.myParticleEmitters.size())
+			{
+				continue;
+			}
+
+			VFXEmitter& source = sq.myParticleEmitters[vfxTS.myEffectIndex];
+			const int firstFrame = vfxTS.myStartpoint - myEmitterLookahead;
+			const int lastFrame = vfxTS.myEndpoint + (int)std::ceil(source.myEmitter.GetSharedAttributes().lifeTimeMax * VFX_SEQUENCE_FRAME_RATE);
+			const auto isInWindow = [firstFrame, lastFrame](int aFrame) { return aFrame >= firstFrame && aFrame <= lastFrame; };
+
+			//looping players also need the tail of the previous loop and the lookahead into the next one
+			const bool isWanted = isInWindow(frame) || (aPlayerData.myIsLooping && (isInWindow(frame + sq.myDuration) || isInWindow(frame - sq.myDuration)));
+
+			auto active = std::ranges::find_if(aPlayerData.myEmitters, [ts](const VFXEmitter& anEmitter) { return anEmitter.myTimestampIndex == ts; });
+			if (isWanted && active == aPlayerData.myEmitters.end())
+			{
+				VFXEmitter& emitter = aPlayerData.myEmitters.emplace_back(source);
+				emitter.myTemplateIndex = vfxTS.myEffectIndex;
+				emitter.myTimestampIndex = ts;
+				//the template's window is only one of the timestamps that use it, the copy runs on its own
+				emitter.myStartFrame = vfxTS.myStartpoint;
+				emitter.myEndFrame = vfxTS.myEndpoint;
+				ApplyLODToEmitter(emitter, sq, aPlayerData.myLODLevel);
+			}
+			else if (!isWanted && active != aPlayerData.myEmitters.end())
+			{
+				aPlayerData.myEmitters.erase(active);
+			}
+		}
+	}
+
+	void VFXManager::Seek(VFXInstanceHandle aHandle, int aFrame)
+	{
+		if (myTraceRecorder)
+		{
+			myTraceRecorder->RecordSeek(aHandle, aFrame);
+		}
+
+		for (auto& playerData : myRenderQueue)
+		{
+			if (playerData.myHandle == aHandle)
+			{
+				SeekPlayer(playerData, aFrame);
+				return;
+			}
+		}
+	}
+
+	void VFXManager::SeekPlayer(VFXSequencePlayerData& aPlayerData, int aFrame)
+	{
+		//meshes are a pure function of the frame, only the emitters need their recent history rebuilt
+		const VFXSequence& sq = myVFXSequences[aPlayerData.mySequenceIndex];
+		aFrame = std::clamp(aFrame, 0, sq.myDuration);
+
+		aPlayerData.myTimer = (float)aFrame;
+		aPlayerData.myFrame = aFrame;
+		aPlayerData.myEmitters.clear();
+		UpdateEmitterResidency(aPlayerData);
+
+		for (VFXEmitter& emitter : aPlayerData.myEmitters)
+		{
+			CatchUpEmitter(emitter, aPlayerData.myRenderInput.GetTransform(), aFrame, sq.myDuration, aPlayerData.myIsLooping);
+		}
+	}
+
+	void VFXManager::PrewarmSequenceEmitters(int aVFXSequenceIndex, int aFrame, Transform& aTransform, std::vector<VFXEmitter>& someOutEmitters)
+	{
+		//live players copy the templates, so the particles are built on copies and the templates stay empty
+		EnsureVFXSequenceResident(aVFXSequenceIndex);
+		const VFXSequence& sq = myVFXSequences[aVFXSequenceIndex];
+		someOutEmitters = sq.myParticleEmitters;
+		for (VFXEmitter& emitter : someOutEmitters)
+		{
+			CatchUpEmitter(emitter, aTransform, aFrame, sq.myDuration, false);
+		}
+	}
+
+	void VFXManager::CatchUpEmitter(VFXEmitter& anEmitter, Transform& aTransform, int aFrame, int aDuration, bool aIsLooping)
+	{
+		//particles older than the max lifetime are gone by frame N no matter what happened before,
+		//so only that tail gets simulated and it's done in large fixed steps instead of N real ticks.
+		//simulating a full lifetime also ages out whatever the emitter held before, so no reset is needed
+		const int lifetimeFrames = (int)std::ceil(anEmitter.myEmitter.GetSharedAttributes().lifeTimeMax * VFX_SEQUENCE_FRAME_RATE);
+		const int framesPerStep = std::max((int)(VFX_PREWARM_STEP * VFX_SEQUENCE_FRAME_RATE), 1);
+
+		//the emitter only reads the global delta time. seeks, prewarms and queued commands all run on the update thread
+		//and nothing in the loop returns early, so the swap is always put back before anything else reads it
+		const float deltaTimeCache = KE_GLOBAL::deltaTime;
+		KE_GLOBAL::deltaTime = (float)framesPerStep / (float)VFX_SEQUENCE_FRAME_RATE;
+
+		for (int frame = aFrame - lifetimeFrames; frame < aFrame; frame += framesPerStep)
+		{
+			int sequenceFrame = frame;
+			if (sequenceFrame < 0)
+			{
+				if (!aIsLooping || aDuration <= 0) { continue; }
+				sequenceFrame += aDuration * (1 + -sequenceFrame / aDuration);
+				sequenceFrame %= aDuration;
+			}
+
+			anEmitter.myEmitter.Update(
+				aTransform,
+				sequenceFrame >= anEmitter.myStartFrame && sequenceFrame <= anEmitter.myEndFrame && !anEmitter.myIsLODHidden
+			);
+		}
+
+		KE_GLOBAL::deltaTime = deltaTimeCache;
+	}
+
+	void VFXManager::UpdateEmitters(VFXSequencePlayerData& aPlayerData)
+	{
+		UpdateEmitterResidency(aPlayerData);
+
+		for (auto& emitter : aPlayerData.myEmitters)
+		{
+			emitter.myEmitter.Update(
+				aPlayerData.myRenderInput.GetTransform(),
+				aPlayerData.myFrame >= emitter.myStartFrame && aPlayerData.myFrame <= emitter.myEndFrame && !emitter.myIsLODHidden
+			);
+		}
+	}
+
+	void VFXManager::BuildSpriteBatchGroups()
+	{
+		//every emitter that shares texture, mode and layer gets appended into one batch so it costs one bind and draw
+		auto& spriteBatchGroups = myRenderSnapshots[myWriteSnapshot].mySpriteBatchGroups;
+		for (VFXSpriteBatchGroup& group : spriteBatchGroups)
+		{
+			group.myBatch.myInstances.clear();
+			group.mySourceBatchCount = 0;
+		}
+
+		for (auto& playerData : myRenderQueue)
+		{
+			for (auto& emitter : playerData.myEmitters)
+			{
+				AppendToSpriteBatchGroup(*emitter.myEmitter.GetSpriteBatch(), playerData.myLayer, nullptr);
+			}
+		}
+
+		//shared emitters simulate around the origin, every placement gets a transformed copy
+		for (auto& sharedSimulation : mySharedSimulations)
+		{
+			for (auto& emitter : sharedSimulation.myPlayerData.myEmitters)
+			{
+				if (std::ranges::none_of(emitter.myEmitter.GetSpriteBatch()->myInstances, IsVFXParticleAlive)) { continue; }
+
+				for (auto& placement : sharedSimulation.myPlacements)
+				{
+					AppendToSpriteBatchGroup(*emitter.myEmitter.GetSpriteBatch(), placement.myRenderInput.myLayer, &placement.myRenderInput.GetTransform());
+				}
+			}
+		}
+
+		std::erase_if(spriteBatchGroups, [](const VFXSpriteBatchGroup& aGroup) { return aGroup.mySourceBatchCount == 0; });
+	}
+
+	void VFXManager::AppendToSpriteBatchGroup(SpriteBatch& aSourceBatch, eRenderLayers aLayer, Transform* aPlacement)
+	{
+		//only live particles are copied, a batch with none doesn't get a group
+		if (std::ranges::none_of(aSourceBatch.myInstances, IsVFXParticleAlive)) { return; }
+
+		//atlased textures batch with everything else on their page, their UVs get moved into the page's sub-rect
+		const VFXAtlasEntry* atlasEntry = myParticleAtlas.Find(aSourceBatch.myData.myTexture);
+		auto* texture = atlasEntry ? atlasEntry->page : aSourceBatch.myData.myTexture;
+
+		auto& spriteBatchGroups = myRenderSnapshots[myWriteSnapshot].mySpriteBatchGroups;
+		VFXSpriteBatchGroup* group = nullptr;
+		for (VFXSpriteBatchGroup& existingGroup : spriteBatchGroups)
+		{
+			if (existingGroup.myLayer == aLayer &&
+				existingGroup.myBatch.myData.myTexture == texture &&
+				existingGroup.myBatch.myData.myMode == aSourceBatch.myData.myMode)
+			{
+				group = &existingGroup;
+				break;
+			}
+		}
+
+		if (!group)
+		{
+			group = &spriteBatchGroups.emplace_back();
+			group->myBatch.myData = aSourceBatch.myData;
+			group->myBatch.myData.myTexture = texture;
+			group->myLayer = aLayer;
+		}
+
+		auto& instances = group->myBatch.myInstances;
+		const size_t firstInstance = instances.size();
+		std::ranges::copy_if(aSourceBatch.myInstances, std::back_inserter(instances), IsVFXParticleAlive);
+		group->mySourceBatchCount++;
+
+		if (!aPlacement && !atlasEntry) { return; }
+
+		for (size_t i = firstInstance; i < instances.size(); i++)
+		{
+			auto& instance = instances[i];
+			if (aPlacement)
+			{
+				instance.myTransform = *aPlacement * instance.myTransform;
+			}
+			if (atlasEntry)
+			{
+				instance.myAttributes.mySamplingData = RemapVFXAtlasUV(instance.myAttributes.mySamplingData, atlasEntry->uvTransform);
+			}
+		}
+	}
+
+	void VFXManager::BuildParticleAtlas()
+	{
+		std::vector<Texture*> textures;
+		for (VFXSequence& sq : myVFXSequences)
+		{
+			for (VFXEmitter& emitter : sq.myParticleEmitters)
+			{
+				Texture* texture = emitter.myEmitter.GetSpriteBatch()->myData.myTexture;
+				if (std::ranges::find(textures, texture) == textures.end())
+				{
+					textures.push_back(texture);
+				}
+			}
+		}
+
+		//only new textures get copied, emptied pages wait until the render thread is past every frame that sampled them
+		VFXRetiredResources retired;
+		myParticleAtlas.Update(myGraphics, textures, retired.myAtlasPages);
+		if (!retired.myAtlasPages.empty()) { myRetiredResources.push_back(std::move(retired)); }
+		myParticleAtlasDirty = false;
+	}
+
+	void VFXManager::Resize(int aWidth, int aHeight)
+	{
+		myVFXPostProcessing.ConfigureDownSampleRTs(myGraphics, aWidth, aHeight);
+	}
+
+	void VFXManager::EndFrame()
+	{
+		if (ApplyPendingReloads() && myIsPipelined)
+		{
+			//the packages built this update point into the meshes the reload retired
+			RebuildRenderSnapshot();
+		}
+
+		if (myIsPipelined)
+		{
+			//hands this frame over and takes back whichever buffer the render thread isn't going to read
+			myWriteSnapshot = myMiddleSnapshot.exchange(myWriteSnapshot | VFX_SNAPSHOT_PUBLISHED, std::memory_order_acq_rel) & VFX_SNAPSHOT_INDEX_MASK;
+		}
+		ReleaseRetiredResources();
+
+		VFXRenderSnapshot& snapshot = myRenderSnapshots[myWriteSnapshot];
+		snapshot.myRenderPackages.clear();
+		snapshot.mySubmittedPackageCount = 0;
+		for (VFXViewSubmission& submission : snapshot.myViewSubmissions)
+		{
+			submission.myPackageIndices.clear();
+		}
+	}
+
+	void VFXManager::BeginRenderFrame()
+	{
+		if (!myIsPipelined) { return; }
+
+		//the buffer drawn last frame goes back to the middle for update to reuse, nothing reads it after this
+		if (myMiddleSnapshot.load(std::memory_order_acquire) & VFX_SNAPSHOT_PUBLISHED)
+		{
+			myRenderSnapshot = myMiddleSnapshot.exchange(myRenderSnapshot, std::memory_order_acq_rel) & VFX_SNAPSHOT_INDEX_MASK;
+		}
+		myRenderFence.fetch_add(1, std::memory_order_release);
+	}
+
+	void VFXManager::SetPipelinedRendering(bool aIsPipelined)
+	{
+		//only safe to call while nothing is rendering
+		myIsPipelined = aIsPipelined;
+		myWriteSnapshot = 0;
+		myMiddleSnapshot.store(1, std::memory_order_release);
+		myRenderSnapshot = 2;
+		myRetiredResources.clear();
+
+		for (VFXRenderSnapshot& snapshot : myRenderSnapshots)
+		{
+			snapshot.myRenderPackages.clear();
+			snapshot.mySpriteBatchGroups.clear();
+		}
+	}
+
+	int VFXManager::GetRenderSnapshotIndex() const
+	{
+		//nothing taken yet, the render buffer is still empty
+		return myIsPipelined ? myRenderSnapshot : myWriteSnapshot;
+	}
+
+	void VFXManager::RetireMeshes(VFXSequence& aSequence)
+	{
+		//published packages point into the mesh array, the whole array is kept so none of the pointers move
+		if (!myIsPipelined || aSequence.myVFXMeshes.empty()) { return; }
+		myRetiredResources.emplace_back().myMeshes = std::move(aSequence.myVFXMeshes);
+		aSequence.myVFXMeshes = {};
+	}
+
+	void VFXManager::ReleaseRetiredResources()
+	{
+		if (!myIsPipelined)
+		{
+			//called after the frame rendered
+			myRetiredResources.clear();
+			return;
+		}
+
+		//the render thread can still be drawing the frame it took just before this frame was published, the one
+		//after that is the first that can't use them. called right after publishing, so the stamp is taken here
+		const uint64_t fence = myRenderFence.load(std::memory_order_acquire);
+		for (VFXRetiredResources& retired : myRetiredResources)
+		{
+			if (retired.myRenderFence == 0) { retired.myRenderFence = fence + 2; }
+		}
+		std::erase_if(myRetiredResources, [fence](const VFXRetiredResources& aRetired) { return fence >= aRetired.myRenderFence; });
+	}
+
+	void VFXManager::PrepareRenderData(VFXSequencePlayerData& aPlayerData)
+	{
+		KE::VFXSequence& sq = myVFXSequences[aPlayerData.mySequenceIndex];
+		VFXPackageCache& cache = aPlayerData.myPackageCache;
+
+		DirectX::XMFLOAT4X4 transform;
+		DirectX::XMStoreFloat4x4(&transform, aPlayerData.myRenderInput.GetTransform().GetMatrix());
+		const bool hasMoved = std::memcmp(&transform, &cache.myTransform, sizeof(transform)) != 0;
+
+		myVisibleTimestamps.clear();
+		for (int ts = 0; ts < sq.myTimestamps.size(); ts++)
+		{
+			const VFXTimeStamp& vfxTS = sq.myTimestamps[ts];
+			if (vfxTS.myType != VFXType::VFXMeshInstance || vfxTS.myStartpoint > aPlayerData.myFrame || vfxTS.myEndpoint < aPlayerData.myFrame)
+			{
+				continue;
+			}
+			if (sq.IsTimestampHidden(aPlayerData.myLODLevel, ts))
+			{
+				continue;
+			}
+			myVisibleTimestamps.push_back(ts);
+		}
+
+		const bool isCacheValid =
+			cache.myFrame >= 0 &&
+			cache.mySequenceRevision == sq.myRevision &&
+			cache.myLODLevel == aPlayerData.myLODLevel &&
+			cache.myTimestamps == myVisibleTimestamps &&
+			std::ranges::all_of(cache.myPackages, [&aPlayerData](const VFXSequenceRenderPackage& aPackage)
+			{
+				return aPackage.layer == aPlayerData.myLayer && aPackage.bloom == aPlayerData.myRenderInput.bloom;
+			});
+
+		if (!isCacheValid)
+		{
+			cache.myPackages.clear();
+			cache.myTimestamps = myVisibleTimestamps;
+		}
+
+		for (int i = 0; i < cache.myTimestamps.size(); i++)
+		{
+			const VFXTimeStamp& vfxTS = sq.myTimestamps[cache.myTimestamps[i]];
+			VFXMeshInstance& mesh = sq.myVFXMeshes[vfxTS.myEffectIndex];
+
+			if (!isCacheValid)
+			{
+				VFXSequenceRenderPackage& renderPackage = cache.myPackages.emplace_back();
+				renderPackage.layer = aPlayerData.myLayer;
+				renderPackage.modelData = mesh.GetModelData();
+
+				EvaluateRenderPackageAttributes(renderPackage, sq, vfxTS, aPlayerData.myFrame);
+				FinalizeRenderPackage(renderPackage, mesh, aPlayerData.myRenderInput);
+				continue;
+			}
+
+			//the frame only advances at the sequence's frame rate and most curves hold still for long stretches
+			VFXSequenceRenderPackage& renderPackage = cache.myPackages[i];
+			const bool isConstant = vfxTS.IsConstantBetween(cache.myFrame, aPlayerData.myFrame);
+			if (!isConstant)
+			{
+				EvaluateRenderPackageAttributes(renderPackage, sq, vfxTS, aPlayerData.myFrame);
+			}
+			if (!isConstant || hasMoved)
+			{
+				FinalizeRenderPackage(renderPackage, mesh, aPlayerData.myRenderInput);
+			}
+		}
+
+		cache.myTransform = transform;
+		cache.myFrame = aPlayerData.myFrame;
+		cache.mySequenceRevision = sq.myRevision;
+		cache.myLODLevel = aPlayerData.myLODLevel;
+
+		auto& packages = myRenderSnapshots[myWriteSnapshot].myRenderPackages;
+		packages.insert(packages.end(), cache.myPackages.begin(), cache.myPackages.end());
+	}
+
+	void VFXManager::PrepareSharedRenderData(VFXSharedSimulation& aSharedSimulation)
+	{
+		//curves are evaluated once for the shared timeline, each placement only pays for its transform
+		VFXSequencePlayerData& playerData = aSharedSimulation.myPlayerData;
+		KE::VFXSequence& sq = myVFXSequences[playerData.mySequenceIndex];
+		VFXPackageCache& cache = playerData.myPackageCache;
+
+		myVisibleTimestamps.clear();
+		for (int ts = 0; ts < sq.myTimestamps.size(); ts++)
+		{
+			VFXTimeStamp& vfxTS = sq.myTimestamps[ts];
+			if (vfxTS.myType != VFXType::VFXMeshInstance || vfxTS.myStartpoint > playerData.myFrame || vfxTS.myEndpoint < playerData.myFrame)
+			{
+				continue;
+			}
+			if (sq.IsTimestampHidden(playerData.myLODLevel, ts))
+			{
+				continue;
+			}
+			myVisibleTimestamps.push_back(ts);
+		}
+
+		//the cache holds the evaluated but unplaced packages
+		const bool isCacheValid =
+			cache.myFrame >= 0 &&
+			cache.mySequenceRevision == sq.myRevision &&
+			cache.myLODLevel == playerData.myLODLevel &&
+			cache.myTimestamps == myVisibleTimestamps;
+
+		if (!isCacheValid)
+		{
+			cache.myPackages.assign(myVisibleTimestamps.size(), {});
+			cache.myTimestamps = myVisibleTimestamps;
+		}
+
+		for (int i = 0; i < cache.myTimestamps.size(); i++)
+		{
+			const VFXTimeStamp& vfxTS = sq.myTimestamps[cache.myTimestamps[i]];
+			VFXMeshInstance& mesh = sq.myVFXMeshes[vfxTS.myEffectIndex];
+			VFXSequenceRenderPackage& sharedPackage = cache.myPackages[i];
+
+			if (!isCacheValid || !vfxTS.IsConstantBetween(cache.myFrame, playerData.myFrame))
+			{
+				sharedPackage.modelData = mesh.GetModelData();
+				EvaluateRenderPackageAttributes(sharedPackage, sq, vfxTS, playerData.myFrame);
+			}
+
+			for (auto& placement : aSharedSimulation.myPlacements)
+			{
+				VFXSequenceRenderPackage& renderPackage = myRenderSnapshots[myWriteSnapshot].myRenderPackages.emplace_back(sharedPackage);
+				renderPackage.layer = placement.myRenderInput.myLayer;
+				FinalizeRenderPackage(renderPackage, mesh, placement.myRenderInput);
+			}
+		}
+
+		cache.myFrame = playerData.myFrame;
+		cache.mySequenceRevision = sq.myRevision;
+		cache.myLODLevel = playerData.myLODLevel;
+	}
+
+	void VFXManager::EvaluateRenderPackageAttributes(VFXSequenceRenderPackage& aPackage, const VFXSequence& aSequence, const VFXTimeStamp& aTimestamp, int aFrame) const
+	{
+		for (auto& modifier : aTimestamp.myCurveDataSets)
+		{
+			if (!modifier.IsValid()) { continue; }
+			const float mod = modifier.GetEvaluatedValue(aFrame, aTimestamp.myStartpoint, aTimestamp.myEndpoint);
+			float* base = (float*)&aPackage.attributes;
+			base += (int)modifier.myType;
+			*base = mod;
+		}
+
+		auto& custom = aPackage.attributes.custom;
+		for (int i = 0; i < custom.size(); i++)
+		{
+			const VFXCurveDataSet& curve = aTimestamp.myCustomCurveDataSets[i];
+			if (i >= aSequence.myCustomAttributes.size())
+			{
+				custom[i] = 0.0f;
+			}
+			else if (curve.IsValid() && !curve.myData.empty())
+			{
+				custom[i] = curve.GetEvaluatedValue(aFrame, aTimestamp.myStartpoint, aTimestamp.myEndpoint);
+			}
+			else
+			{
+				custom[i] = aSequence.myCustomAttributes[i].myDefaultValue;
+			}
+		}
+	}
+
+	void VFXManager::FinalizeRenderPackage(VFXSequenceRenderPackage& aPackage, VFXMeshInstance& aMesh, VFXRenderInput& aRenderInput) const
+	{
+		aPackage.bloom = aRenderInput.bloom;
+		aPackage.passes = aMesh.GetPasses();
+		aPackage.instanceTransform = aRenderInput.GetTransform() * aMesh.myTransform;
+
+		Vector3f scl = aPackage.instanceTransform.GetScale();
+		if (aRenderInput.scaleOverride.x > -1.0f)
+		{
+			scl = aRenderInput.scaleOverride;
+		}
+
+		Vector3f rot = {
+			KE::DegToRad(aPackage.attributes.rotation.x),
+			KE::DegToRad(aPackage.attributes.rotation.y),
+			KE::DegToRad(aPackage.attributes.rotation.z)
+		};
+
+		aPackage.instanceTransform.TranslateLocal(aPackage.attributes.translation);
+
+		DirectX::XMMATRIX rotationMatrix = DirectX::XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z);
+		aPackage.instanceTransform = rotationMatrix * aPackage.instanceTransform.GetMatrix();
+
+		aPackage.instanceTransform.SetScale({
+			scl.x * aPackage.attributes.scale.x,
+			scl.y * aPackage.attributes.scale.y,
+			scl.z * aPackage.attributes.scale.z
+			});
+
+		aPackage.customBuffer = aRenderInput.customBufferInput;
+	}
+
+	void VFXManager::ApplyLODLevel(VFXSequencePlayerData& aPlayerData, int aLODLevel)
+	{
+		//emitters keep their particles when switching, hidden ones just stop emitting so the timeline never restarts
+		VFXSequence& sq = myVFXSequences[aPlayerData.mySequenceIndex];
+		aPlayerData.myLODLevel = aLODLevel;
+
+		for (VFXEmitter& emitter : aPlayerData.myEmitters)
+		{
+			ApplyLODToEmitter(emitter, sq, aLODLevel);
+		}
+	}
+
+	void VFXManager::ApplyLODToEmitter(VFXEmitter& anEmitter, VFXSequence& aSequence, int aLODLevel)
+	{
+		const VFXLODLevel* lod = aSequence.GetLODLevel(aLODLevel);
+		const float particleMultiplier = lod ? lod->myParticleMultiplier : 1.0f;
+		anEmitter.myIsLODHidden = aSequence.IsTimestampHidden(aLODLevel, anEmitter.myTimestampIndex);
+
+		auto& source = aSequence.myParticleEmitters[anEmitter.myTemplateIndex].myEmitter.GetSharedAttributes();
+		auto& attr = anEmitter.myEmitter.GetSharedAttributes();
+
+		attr.burstCountMin = static_cast<decltype(attr.burstCountMin)>(source.burstCountMin * particleMultiplier);
+		attr.burstCountMax = static_cast<decltype(attr.burstCountMax)>(source.burstCountMax * particleMultiplier);
+	}
+
+	void VFXManager::InitializeVFXMesh(VFXMeshInstance& aMeshToInitialize) const
+	{
+		ModelData& modelData = *aMeshToInitialize.GetModelData();
+		modelData.myTransform = &aMeshToInitialize.GetTransform()->GetMatrix();
+		modelData.myMeshList = &myGraphics->GetModelLoader().Load("Data/InternalAssets/cylinder.fbx");
+		auto& rr = modelData.myRenderResources.emplace_back();
+		rr.myMaterial = myGraphics->GetTextureLoader().GetDefaultMaterial();
+		rr.myPixelShader = myGraphics->GetShaderLoader().GetPixelShader(SHADER_LOAD_PATH "Model_VFX_PS.cso");
+		rr.myVertexShader = myGraphics->GetShaderLoader().GetVertexShader(SHADER_LOAD_PATH "Model_VFX_VS.cso");
+
+		aMeshToInitialize.myShape = GetMeshShape(*modelData.myMeshList);
+	}
+
+	void VFXManager::AnalyzeVFXMesh(VFXMeshInstance& aMesh) const
+	{
+		if (aMesh.myModelData.myMeshList) { aMesh.myShape = GetMeshShape(*aMesh.myModelData.myMeshList); }
+	}
+
+	void VFXManager::InitializeParticleEmitter(ParticleEmitter& anEmitterToInitialize) const
+	{
+		anEmitterToInitialize.Init(myGraphics, VFX_PARTICLE_EMITTER_CAPACITY, "Data/InternalAssets/defaultTexture.png");
+	}
+
+	VFXInstanceHandle VFXManager::TriggerVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput)
+	{
+		const VFXInstanceHandle handle = ReserveHandle();
+		TriggerWithHandle(aVFXSequenceIndex, aRenderInput, handle);
+		return handle;
+	}
+
+	void VFXManager::TriggerWithHandle(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput, VFXInstanceHandle aHandle)
+	{
+		EnsureVFXSequenceResident(aVFXSequenceIndex);
+
+		if (myTraceRecorder)
+		{
+			myTraceRecorder->RecordTrigger(aVFXSequenceIndex, myVFXSequences[aVFXSequenceIndex].myName, aRenderInput, aHandle);
+		}
+
+		if (IsSharedRenderInput(aRenderInput))
+		{
+			AddSharedPlacement(aVFXSequenceIndex, aRenderInput, aHandle);
+			return;
+		}
+
+		VFXSequencePlayerData& sqData = myRenderQueue.emplace_back(aRenderInput);
+		InitializePlayerData(sqData, aVFXSequenceIndex, aHandle);
+		if (aRenderInput.prewarm || aRenderInput.startFrame > 0)
+		{
+			SeekPlayer(sqData, aRenderInput.startFrame);
+		}
+	}
+
+	VFXInstanceHandle VFXManager::EnqueueTrigger(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput)
+	{
+		VFXCommand command;
+		command.type = VFXCommandType::Trigger;
+		command.sequenceIndex = aVFXSequenceIndex;
+		command.handle = ReserveHandle();
+		command.renderInput.emplace(aRenderInput);
+
+		return myCommandQueue.TryPush(command) ? command.handle : VFX_INVALID_HANDLE;
+	}
+
+	bool VFXManager::EnqueueStop(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput)
+	{
+		VFXCommand command;
+		command.type = VFXCommandType::StopSequence;
+		command.sequenceIndex = aVFXSequenceIndex;
+		command.renderInput.emplace(aRenderInput);
+		return myCommandQueue.TryPush(command);
+	}
+
+	bool VFXManager::EnqueueStopInstance(VFXInstanceHandle aHandle)
+	{
+		VFXCommand command;
+		command.type = VFXCommandType::StopInstance;
+		command.handle = aHandle;
+		return myCommandQueue.TryPush(command);
+	}
+
+	bool VFXManager::EnqueueSetTransform(VFXInstanceHandle aHandle, const Transform& aTransform)
+	{
+		VFXCommand command;
+		command.type = VFXCommandType::SetTransform;
+		command.handle = aHandle;
+		command.transform = aTransform;
+		return myCommandQueue.TryPush(command);
+	}
+
+	void VFXManager::ExecuteQueuedCommands()
+	{
+		while (myCommandQueue.TryPop(myDrainCommand))
+		{
+			switch (myDrainCommand.type)
+			{
+			case VFXCommandType::Trigger:
+				TriggerWithHandle(myDrainCommand.sequenceIndex, *myDrainCommand.renderInput, myDrainCommand.handle);
+				break;
+			case VFXCommandType::StopSequence:
+				StopVFXSequence(myDrainCommand.sequenceIndex, *myDrainCommand.renderInput);
+				break;
+			case VFXCommandType::StopInstance:
+				StopVFXInstance(myDrainCommand.handle);
+				break;
+			case VFXCommandType::SetTransform:
+				SetInstanceTransform(myDrainCommand.handle, myDrainCommand.transform);
+				break;
+			}
+		}
+	}
+
+	void VFXManager::SetInstanceTransform(VFXInstanceHandle aHandle, const Transform& aTransform)
+	{
+		if (myTraceRecorder)
+		{
+			myTraceRecorder->RecordSetTransform(aHandle, aTransform);
+		}
+
+		//attached inputs follow the transform they point at, only stationary ones store their own
+		for (auto& playerData : myRenderQueue)
+		{
+			if (playerData.myHandle != aHandle) { continue; }
+			if (playerData.myRenderInput.isStationary) { playerData.myRenderInput.myStationaryTransform = aTransform; }
+			return;
+		}
+
+		for (auto& sharedSimulation : mySharedSimulations)
+		{
+			for (auto& placement : sharedSimulation.myPlacements)
+			{
+				if (placement.myHandle != aHandle) { continue; }
+				placement.myRenderInput.myStationaryTransform = aTransform;
+				return;
+			}
+		}
+	}
+
+	std::vector<VFXInstanceHandle> VFXManager::TriggerVFXSequenceBatch(int aVFXSequenceIndex, std::span<const VFXRenderInput> aRenderInputs)
+	{
+		EnsureVFXSequenceResident(aVFXSequenceIndex);
+
+		std::vector<VFXInstanceHandle> handles;
+		handles.reserve(aRenderInputs.size());
+
+		//grow once for the whole batch, but keep the geometric growth so repeated bursts don't reallocate every time
+		const size_t requiredCapacity = myRenderQueue.size() + aRenderInputs.size();
+		if (myRenderQueue.capacity() < requiredCapacity)
+		{
+			myRenderQueue.reserve(std::max(requiredCapacity, myRenderQueue.capacity() * 2));
+		}
+
+		for (const VFXRenderInput& renderInput : aRenderInputs)
+		{
+			if (IsSharedRenderInput(renderInput))
+			{
+				const VFXInstanceHandle handle = ReserveHandle();
+				AddSharedPlacement(aVFXSequenceIndex, renderInput, handle);
+				handles.push_back(handle);
+				continue;
+			}
+
+			VFXSequencePlayerData& sqData = myRenderQueue.emplace_back(renderInput);
+			InitializePlayerData(sqData, aVFXSequenceIndex, ReserveHandle());
+			if (renderInput.prewarm || renderInput.startFrame > 0)
+			{
+				SeekPlayer(sqData, renderInput.startFrame);
+			}
+			handles.push_back(sqData.myHandle);
+		}
+
+		if (myTraceRecorder)
+		{
+			for (int i = 0; i < aRenderInputs.size(); i++)
+			{
+				myTraceRecorder->RecordTrigger(aVFXSequenceIndex, myVFXSequences[aVFXSequenceIndex].myName, aRenderInputs[i], handles[i]);
+			}
+		}
+
+		return handles;
+	}
+
+	std::vector<VFXInstanceHandle> VFXManager::TriggerVFXSequenceBatch(int aVFXSequenceIndex, std::span<Transform> aTransforms, const VFXRenderInput& aRenderInput)
+	{
+		myBatchInputs.clear();
+		myBatchInputs.reserve(aTransforms.size());
+
+		for (Transform& transform : aTransforms)
+		{
+			VFXRenderInput& renderInput = myBatchInputs.emplace_back(aRenderInput);
+			if (renderInput.isStationary)
+			{
+				renderInput.myStationaryTransform = transform;
+			}
+			else
+			{
+				renderInput.myTransform = &transform;
+			}
+		}
+
+		return TriggerVFXSequenceBatch(aVFXSequenceIndex, myBatchInputs);
+	}
+
+	void VFXManager::InitializePlayerData(VFXSequencePlayerData& aPlayerData, int aVFXSequenceIndex, VFXInstanceHandle aHandle)
+	{
+		aPlayerData.myHandle = aHandle;
+		aPlayerData.mySequenceIndex = aVFXSequenceIndex;
+		aPlayerData.myTimer = 0.0f;
+		aPlayerData.myFrame = 0;
+		aPlayerData.myIsLooping = aPlayerData.myRenderInput.looping;
+		aPlayerData.myLayer = aPlayerData.myRenderInput.myLayer;
+		aPlayerData.myEmitters.clear();
+	}
+
+	static bool IsSameRenderInput(const VFXRenderInput& aRenderInput, const VFXRenderInput& anOtherRenderInput)
+	{
+		//stationary inputs carry their own copy of the transform in the union, those have to match by value
+		if (aRenderInput.isStationary != anOtherRenderInput.isStationary) { return false; }
+		if (!aRenderInput.isStationary) { return aRenderInput.myTransform == anOtherRenderInput.myTransform; }
+
+		Transform transform = aRenderInput.myStationaryTransform;
+		Transform otherTransform = anOtherRenderInput.myStationaryTransform;
+		const DirectX::XMMATRIX matrix = transform.GetMatrix();
+		const DirectX::XMMATRIX otherMatrix = otherTransform.GetMatrix();
+		for (int row = 0; row < 4; row++)
+		{
+			if (!DirectX::XMVector4Equal(matrix.r[row], otherMatrix.r[row])) { return false; }
+		}
+		return true;
+	}
+
+	void VFXManager::StopVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput)
+	{
+		if (myTraceRecorder)
+		{
+			myTraceRecorder->RecordStop(aVFXSequenceIndex, myVFXSequences[aVFXSequenceIndex].myName, aRenderInput);
+		}
+
+		//this is stupid but fuck it, we look for a playerData with the same index and transform
+		for (int i = 0; i < myRenderQueue.size(); i++)
+		{
+			if (myRenderQueue[i].mySequenceIndex == aVFXSequenceIndex &&
+				IsSameRenderInput(myRenderQueue[i].myRenderInput, aRenderInput))
+			{
+				myRenderQueue.erase(myRenderQueue.begin() + i);
+				i--;
+			}
+		}
+
+		for (int i = 0; i < mySharedSimulations.size(); i++)
+		{
+			VFXSharedSimulation& sharedSimulation = mySharedSimulations[i];
+			if (sharedSimulation.myPlayerData.mySequenceIndex != aVFXSequenceIndex) { continue; }
+
+			//shared placements are always stationary, so only a stop at the same stationary transform removes one
+			std::erase_if(sharedSimulation.myPlacements, [&aRenderInput](const VFXSharedPlacement& aPlacement)
+			{
+				return IsSameRenderInput(aPlacement.myRenderInput, aRenderInput);
+			});
+
+			if (sharedSimulation.myPlacements.empty())
+			{
+				mySharedSimulations.erase(mySharedSimulations.begin() + i);
+				i--;
+			}
+		}
+	}
+
+	void VFXManager::StopVFXInstance(VFXInstanceHandle aHandle)
+	{
+		if (aHandle == VFX_INVALID_HANDLE) { return; }
+
+		if (myTraceRecorder)
+		{
+			myTraceRecorder->RecordStopInstance(aHandle);
+		}
+
+		const auto player = std::ranges::find_if(myRenderQueue, [aHandle](const VFXSequencePlayerData& aPlayerData)
+		{
+			return aPlayerData.myHandle == aHandle;
+		});
+		if (player != myRenderQueue.end())
+		{
+			myRenderQueue.erase(player);
+			return;
+		}
+
+		for (int i = 0; i < mySharedSimulations.size(); i++)
+		{
+			VFXSharedSimulation& sharedSimulation = mySharedSimulations[i];
+			if (std::erase_if(sharedSimulation.myPlacements, [aHandle](const VFXSharedPlacement& aPlacement) { return aPlacement.myHandle == aHandle; }) == 0)
+			{
+				continue;
+			}
+
+			if (sharedSimulation.myPlacements.empty())
+			{
+				mySharedSimulations.erase(mySharedSimulations.begin() + i);
+			}
+			return;
+		}
+	}
+
+	bool VFXManager::IsSharedRenderInput(const VFXRenderInput& aRenderInput)
+	{
+		return aRenderInput.sharedSimulation && aRenderInput.isStationary && aRenderInput.looping;
+	}
+
+	void VFXManager::AddSharedPlacement(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput, VFXInstanceHandle aHandle)
+	{
+		const VFXSequence& sq = myVFXSequences[aVFXSequenceIndex];
+		const int variantCount = std::clamp(aRenderInput.sharedPhaseVariants, 1, VFX_MAX_SHARED_PHASE_VARIANTS);
+
+		//spread placements over the phase variants so neighbouring torches don't flicker in lockstep
+		VFXSharedSimulation* target = nullptr;
+		for (int variant = 0; variant < variantCount; variant++)
+		{
+			const int phaseOffset = sq.myDuration * variant / variantCount;
+			auto it = std::ranges::find_if(mySharedSimulations, [&](const VFXSharedSimulation& aSimulation)
+			{
+				return aSimulation.myPlayerData.mySequenceIndex == aVFXSequenceIndex && aSimulation.myPhaseOffset == phaseOffset;
+			});
+
+			if (it == mySharedSimulations.end())
+			{
+				Transform origin;
+				VFXRenderInput sharedInput = aRenderInput;
+				sharedInput.myStationaryTransform = origin;
+
+				target = &mySharedSimulations.emplace_back(VFXSharedSimulation{ VFXSequencePlayerData{ sharedInput } });
+				target->myPhaseOffset = phaseOffset;
+
+				VFXSequencePlayerData& sqData = target->myPlayerData;
+				InitializePlayerData(sqData, aVFXSequenceIndex, VFX_INVALID_HANDLE);
+				if (aRenderInput.prewarm)
+				{
+					SeekPlayer(sqData, phaseOffset);
+				}
+				else
+				{
+					sqData.myTimer = (float)phaseOffset;
+					sqData.myFrame = phaseOffset;
+				}
+				break;
+			}
+
+			if (!target || it->myPlacements.size() < target->myPlacements.size())
+			{
+				target = &*it;
+			}
+		}
+
+		target->myPlacements.push_back({ aRenderInput, aHandle });
+	}
+
+	nlohmann::json VFXManager::SerializeVFXSequence(VFXSequence& aSequence)
+	{
+		nlohmann::json output;
+		VFXSequence& sq = aSequence;
+		
+		output["name"] = sq.myName;
+		output["duration"] = sq.myDuration;
+		
+		output["meshes"] = nlohmann::json::array();
+		output["particleEmitters"] = nlohmann::json::array();
+		output["timestamps"] = nlohmann::json::array();
+
+		for (auto& VFXMesh : sq.myVFXMeshes)
+		{
+			nlohmann::json mesh;
+			mesh["name"]	 = VFXMesh.myModelData.myMeshList->myFilePath;
+
+			mesh["albedo"]   = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[0]->myMetadata.myFilePath;
+			mesh["normal"]   = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[1]->myMetadata.myFilePath;
+			mesh["material"] = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[2]->myMetadata.myFilePath;
+			mesh["effects"]  = VFXMesh.myModelData.myRenderResources[0].myMaterial->myTextures[3]->myMetadata.myFilePath;
+
+			mesh["vertexShader"] = VFXMesh.myModelData.myRenderResources[0].myVertexShader->GetName();
+			mesh["pixelShader"] = VFXMesh.myModelData.myRenderResources[0].myPixelShader->GetName();
+			mesh["drawMode"] = (int)VFXMesh.myDrawMode;
+
+			output["meshes"].push_back(mesh);
+		}
+
+		for (auto& emitter : sq.myParticleEmitters)
+		{
+			nlohmann::json em;
+			em["particleCapacity"] = emitter.myEmitter.GetSpriteBatch()->myInstances.size();
+			em["particleTexture"] = emitter.myEmitter.GetSpriteBatch()->myData.myTexture->myMetadata.myFilePath;
+			em["particleMode"] = (int)emitter.myEmitter.GetSpriteBatch()->myData.myMode;
+
+			nlohmann::json spa;
+			auto& attr = emitter.myEmitter.GetSharedAttributes();
+
+			//
+			spa["burstTimeMin"] = attr.burstTimeMin;
+			spa["burstTimeMax"] = attr.burstTimeMax;
+			spa["burstCountMin"] = attr.burstCountMin;
+			spa["burstCountMax"] = attr.burstCountMax;
+
+			spa["velocityMin"] = attr.velocityMin;
+			spa["velocityMax"] = attr.velocityMax;
+
+			spa["accelerationMin"] = attr.accelerationMin;
+			spa["accelerationMax"] = attr.accelerationMax;
+
+			spa["velocityDegradation"] = attr.velocityDegradation;
+			spa["accelerationDegradation"] = attr.accelerationDegradation;
+
+			spa["lifeTimeMin"] = attr.lifeTimeMin;
+			spa["lifeTimeMax"] = attr.lifeTimeMax;
+			spa["lifeTimeMidPoint"] = attr.lifeTimeMidPoint;
+
+			spa["angleMin"] = attr.angleMin;
+			spa["angleMax"] = attr.angleMax;
+
+			spa["horizontalVelocityFactor"] = attr.horizontalVelocityFactor;
+			spa["verticalVelocityFactor"] = attr.verticalVelocityFactor;
+
+			spa["startColor"] = { attr.startColor.x, attr.startColor.y, attr.startColor.z, attr.startColor.w };
+			spa["midColor"] = { attr.midColor.x, attr.midColor.y, attr.midColor.z, attr.midColor.w };
+			spa["endColor"] = { attr.endColor.x, attr.endColor.y, attr.endColor.z, attr.endColor.w };
+
+			spa["startSize"] = attr.startSize;
+			spa["midSize"] = attr.midSize;
+			spa["endSize"] = attr.endSize;
+
+			//
+
+			em["sharedParticleAttributes"] = spa;
+
+			output["particleEmitters"].push_back(em);
+		}
+
+		for (auto& timestamp : sq.myTimestamps)
+		{
+			nlohmann::json ts;
+			ts["type"] = (int)timestamp.myType;
+			ts["start"] = timestamp.myStartpoint;
+			ts["end"] = timestamp.myEndpoint;
+			ts["effectIndex"] = timestamp.myEffectIndex;
+			
+			ts["curves"] = nlohmann::json::array();
+			for (VFXCurveDataSet& curve : timestamp.myCurveDataSets)
+			{
+				nlohmann::json cd;
+				cd["curveAttribute"] = (int)curve.myType;
+				cd["curveProfile"] = (int)curve.myCurveProfile;
+				cd["minValue"] = curve.myMinValue;
+				cd["maxValue"] = curve.myMaxValue;
+				cd["points"] = nlohmann::json::array();
+				
+				for (Vector2f& point : curve.myData)
+				{
+					nlohmann::json p;
+					p["x"] = point.x;
+					p["y"] = point.y;
+					cd["points"].push_back(p);
+				}
+				
+				ts["curves"].push_back(cd);
+			}
+
+			ts["customCurves"] = nlohmann::json::array();
+			for (VFXCurveDataSet& curve : timestamp.myCustomCurveDataSets)
+			{
+				if (!curve.IsValid()) { continue; }
+
+				nlohmann::json cd;
+				cd["customAttribute"] = curve.myCustomIndex;
+				cd["curveProfile"] = (int)curve.myCurveProfile;
+				cd["minValue"] = curve.myMinValue;
+				cd["maxValue"] = curve.myMaxValue;
+				cd["points"] = nlohmann::json::array();
+
+				for (Vector2f& point : curve.myData)
+				{
+					cd["points"].push_back({ { "x", point.x }, { "y", point.y } });
+				}
+
+				ts["customCurves"].push_back(cd);
+			}
+			output["timestamps"].push_back(ts);
+		}
+
+		output["lodLevels"] = nlohmann::json::array();
+		for (int i = 0; i < sq.myLODLevels.size(); i++)
+		{
+			//written as indices so the file stays readable, they're taken from the timestamps at save time
+			std::vector<int> hiddenTimestamps;
+			for (int ts = 0; ts < sq.myTimestamps.size(); ts++)
+			{
+				if (sq.IsTimestampHidden(i + 1, ts)) { hiddenTimestamps.push_back(ts); }
+			}
+
+			nlohmann::json lod;
+			lod["distance"] = sq.myLODLevels[i].myDistance;
+			lod["particleMultiplier"] = sq.myLODLevels[i].myParticleMultiplier;
+			lod["hiddenTimestamps"] = hiddenTimestamps;
+			output["lodLevels"].push_back(lod);
+		}
+
+		output["budget"] = VFXBudgetToJson(sq.myBudget);
+
+		output["customAttributes"] = nlohmann::json::array();
+		for (const VFXCustomAttribute& attribute : sq.myCustomAttributes)
+		{
+			output["customAttributes"].push_back({ { "name", attribute.myName }, { "default", attribute.myDefaultValue } });
+		}
+		return output;
+	}
+
+	void VFXManager::SaveVFXSequence(VFXSequence* aSequence)
+	{
+		std::string filePath;
+		if (WriteVFXSequenceFile(aSequence->myName, SerializeVFXSequence(*aSequence), filePath) == VFXSaveStatus::Failed)
+		{
+			KE_ERROR("Failed to save sequence %s (%i)", aSequence->myName.c_str(), aSequence->myIndex);
+		}
+	}
+
+	void VFXManager::SaveVFXSequenceAsync(VFXSequence* aSequence)
+	{
+		//the snapshot is taken here since the editor keeps changing the sequence, dumping and writing happen on the saver's worker
+		mySequenceSaver.Save(aSequence->myIndex, aSequence->myName, SerializeVFXSequence(*aSequence));
+	}
+
+	void VFXManager::LoadVFXSequence(int aVFXSequenceIndex, const std::string& aFilePath)
+	{
+		KE_VFX_PROFILE_SCOPE(myProfiler, "Load Sequence");
+
+		VFXSequence& sq = myVFXSequences[aVFXSequenceIndex];
+
+		RetireMeshes(sq);
 		sq.myVFXMeshes.clear();
 		sq.myParticleEmitters.clear();
 		sq.myTimestamps.clear();
+		sq.myLODLevels.clear();
+
+		if (mySequenceSources.size() <= aVFXSequenceIndex) { mySequenceSources.resize(aVFXSequenceIndex + 1); }
+		VFXSequenceSource& source = mySequenceSources[aVFXSequenceIndex];
+		source = {};
+
+		nlohmann::json input;
+		const std::string_view packed = myPack.Find(aFilePath);
+		if (!packed.empty())
+		{
+			//parsed straight out of the mapping, packed sequences have no source file to hot reload from
+			input = nlohmann::json::parse(packed.begin(), packed.end());
+		}
+		else
+		{
+			std::string fileToLoad = VFX_SEQUENCE_FILE_LOCATION + aFilePath + ".kittyVFX";
+			std::ifstream file(fileToLoad);
+
+			if (!file.is_open())
+			{
+				//File we're trying to load does not exist. This is currently okay, we create it using the default template.
+				std::filesystem::copy("Data/InternalAssets/VFXSequences/default.kittyVFX", fileToLoad);
+				file.open(fileToLoad);
+
+				if (!file.is_open())
+				{
+					assert(false && "default.kittyVFX not found! attempted to load %s");
+				}
+			}
+
+			file >> input;
+			file.close();
+
+			source.myFilePath = fileToLoad;
+			source.myWriteTime = std::filesystem::last_write_time(fileToLoad);
+		}
+		
+		sq.myVFXMeshes.reserve(32); //temp!? TODO: fix
+
+		//load meshes
+		for (auto& mesh : input["meshes"])
+		{
+			LoadVFXMesh(sq.myVFXMeshes.emplace_back(), mesh);
+		}
+
+		//load particle emitters
+		for (auto& emitter : input["particleEmitters"])
+		{
+			VFXEmitter& emit = sq.myParticleEmitters.emplace_back();
+			LoadVFXEmitterResources(emit.myEmitter, emitter);
+			LoadVFXEmitterAttributes(emit.myEmitter, emitter);
+		}
+
+		//load timestamps
+		for (auto& timestamp : input["timestamps"])
+		{
+			LoadVFXTimestamp(sq.myTimestamps.emplace_back(), timestamp);
+		}
+		HashVFXSequenceSource(source, input);
+
+		LoadVFXSequenceSettings(sq, input);
+		sq.myRevision++;
+		myParticleAtlasDirty = true;
+		MarkVFXSequenceLoaded(aVFXSequenceIndex);
+	}
+
+	void VFXManager::LoadVFXMesh(VFXMeshInstance& aMesh, const nlohmann::json& aMeshData)
+	{
+		ModelData& modelData = aMesh.myModelData;
+		modelData.myMeshList = &myGraphics->GetModelLoader().Load(aMeshData["name"]);
+		modelData.myRenderResources.clear();
+		modelData.myRenderResources.emplace_back();
+		modelData.myRenderResources[0].myMaterial = myGraphics->GetTextureLoader().GetCustomMaterial(
+			aMeshData["albedo"],
+			aMeshData["normal"],
+			aMeshData["material"],
+			aMeshData["effects"]
+		);
+
+		modelData.myRenderResources[0].myVertexShader = myGraphics->GetShaderLoader().GetVertexShader(aMeshData["vertexShader"]);
+		modelData.myRenderResources[0].myPixelShader = myGraphics->GetShaderLoader().GetPixelShader(aMeshData["pixelShader"]);
+		modelData.myTransform = &aMesh.myTransform.GetMatrix();
+
+		aMesh.myShape = GetMeshShape(*modelData.myMeshList);
+		aMesh.myDrawMode = (VFXMeshDrawMode)aMeshData.value("drawMode", (int)VFXMeshDrawMode::Auto);
+	}
+
+	VFXMeshShape VFXManager::GetMeshShape(const MeshList& aMeshList) const
+	{
+		//the model loader shares mesh lists, so each model is only analyzed once
+		const auto cached = myMeshShapes.find(&aMeshList);
+		if (cached != myMeshShapes.end()) { return cached->second; }
+
+		std::vector<Vector3f> positions;
+		std::optional<VFXMeshShape> shape;
+		for (const auto& mesh : aMeshList.myMeshes)
+		{
+			positions.clear();
+			positions.reserve(mesh.myVertices.size());
+			for (const auto& vertex : mesh.myVertices)
+			{
+				positions.push_back({ vertex.x, vertex.y, vertex.z });
+			}
+
+			const VFXMeshShape meshShape = ClassifyVFXMesh(positions, mesh.myIndices);
+			shape = shape ? CombineVFXMeshShapes(*shape, meshShape) : meshShape;
+		}
+
+		return myMeshShapes[&aMeshList] = shape.value_or(VFXMeshShape::Open);
+	}
+
+	void VFXManager::LoadVFXEmitterResources(ParticleEmitter& anEmitter, const nlohmann::json& anEmitterData)
+	{
+		anEmitter.Init(myGraphics, anEmitterData["particleCapacity"], anEmitterData["particleTexture"]);
+	}
+
+	void VFXManager::LoadVFXEmitterAttributes(ParticleEmitter& anEmitter, const nlohmann::json& anEmitterData)
+	{
+		anEmitter.GetSpriteBatch()->myData.myMode = (SpriteBatchMode)anEmitterData["particleMode"];
+
+		auto& attr = anEmitter.GetSharedAttributes();
+		auto& spa = anEmitterData["sharedParticleAttributes"];
+
+		attr.burstTimeMin = spa["burstTimeMin"];
+		attr.burstTimeMax = spa["burstTimeMax"];
+		attr.burstCountMin = spa["burstCountMin"];
+		attr.burstCountMax = spa["burstCountMax"];
+
+		attr.velocityMin = spa["velocityMin"];
+		attr.velocityMax = spa["velocityMax"];
+
+		attr.accelerationMin = spa["accelerationMin"];
+		attr.accelerationMax = spa["accelerationMax"];
+
+		attr.velocityDegradation = spa["velocityDegradation"];
+		attr.accelerationDegradation = spa["accelerationDegradation"];
+
+		attr.lifeTimeMin = spa["lifeTimeMin"];
+		attr.lifeTimeMax = spa["lifeTimeMax"];
+		attr.lifeTimeMidPoint = spa["lifeTimeMidPoint"];
+
+		attr.angleMin = spa["angleMin"];
+		attr.angleMax = spa["angleMax"];
+
+		attr.horizontalVelocityFactor = spa["horizontalVelocityFactor"];
+		attr.verticalVelocityFactor = spa["verticalVelocityFactor"];
+
+		attr.startColor = Vector4f(spa["startColor"][0], spa["startColor"][1], spa["startColor"][2], spa["startColor"][3]);
+		attr.midColor = Vector4f(spa["midColor"][0], spa["midColor"][1], spa["midColor"][2], spa["midColor"][3]);
+		attr.endColor = Vector4f(spa["endColor"][0], spa["endColor"][1], spa["endColor"][2], spa["endColor"][3]);
+
+		attr.startSize = spa["startSize"];
+		attr.midSize = spa["midSize"];
+		attr.endSize = spa["endSize"];
+	}
+
+	void VFXManager::LoadVFXTimestamp(VFXTimeStamp& aTimestamp, const nlohmann::json& aTimestampData)
+	{
+		//reloads start from a clean timestamp so curves that were removed from the file don't linger
+		const bool isOpened = aTimestamp.myIsOpened;
+		aTimestamp = {};
+		aTimestamp.myIsOpened = isOpened;
+
+		aTimestamp.myType = (VFXType)aTimestampData["type"];
+		aTimestamp.myStartpoint = aTimestampData["start"];
+		aTimestamp.myEndpoint = aTimestampData["end"];
+		aTimestamp.myEffectIndex = aTimestampData["effectIndex"];
+
+		for (auto& curve : aTimestampData["curves"])
+		{
+			int index = (int)curve["curveAttribute"];
+			if (index >= (int)VFXAttributeTypes::Count) { continue; }
+
+			VFXCurveDataSet& cd = aTimestamp.myCurveDataSets[index];
+			cd.myType = (VFXAttributeTypes)curve["curveAttribute"];
+			cd.myCurveProfile = (VFXCurveProfiles)curve["curveProfile"];
+			cd.myMinValue = curve["minValue"];
+			cd.myMaxValue = curve["maxValue"];
+
+			for (auto& point : curve["points"])
+			{
+				cd.myData.push_back(Vector2f(point["x"], point["y"]));
+			}
+		}
+
+		if (!aTimestampData.contains("customCurves")) { return; }
+		for (auto& curve : aTimestampData["customCurves"])
+		{
+			const int index = (int)curve["customAttribute"];
+			if (index < 0 || index >= VFX_MAX_CUSTOM_ATTRIBUTES || curve["points"].empty()) { continue; }
+
+			VFXCurveDataSet& cd = aTimestamp.myCustomCurveDataSets[index];
+			cd.myCustomIndex = index;
+			cd.myCurveProfile = (VFXCurveProfiles)curve["curveProfile"];
+			cd.myMinValue = curve["minValue"];
+			cd.myMaxValue = curve["maxValue"];
+
+			for (auto& point : curve["points"])
+			{
+				cd.myData.push_back(Vector2f(point["x"], point["y"]));
+			}
+		}
+	}
 
-		nlohmann::json input;
-		std::string fileToLoad = VFX_SEQUENCE_FILE_LOCATION + aFilePath + ".kittyVFX";
-		std::ifstream file(fileToLoad);
+	void VFXManager::LoadVFXSequenceSettings(VFXSequence& aSequence, const nlohmann::json& anInput)
+	{
+		aSequence.myDuration = anInput["duration"];
 
-		if (!file.is_open())
+		//a template whose timestamp was removed doesn't play, the rest get their window back below
+		for (VFXEmitter& emitter : aSequence.myParticleEmitters)
+		{
+			emitter.myStartFrame = 0;
+			emitter.myEndFrame = 0;
+		}
+		for (const VFXTimeStamp& ts : aSequence.myTimestamps)
 		{
-			//File we're trying to load does not exist. This is currently okay, we create it using the default template.
-			std::filesystem::copy("Data/InternalAssets/VFXSequences/default.kittyVFX", fileToLoad);
-			file.open(fileToLoad);
+			if (ts.myType == VFXType::ParticleEmitter && ts.myEffectIndex < aSequence.myParticleEmitters.size())
+			{
+				aSequence.myParticleEmitters[ts.myEffectIndex].myStartFrame = ts.myStartpoint;
+				aSequence.myParticleEmitters[ts.myEffectIndex].myEndFrame = ts.myEndpoint;
+			}
+		}
 
-			if (!file.is_open())
+		//load lod levels, older sequences don't have any
+		aSequence.myLODLevels.clear();
+		for (VFXTimeStamp& timestamp : aSequence.myTimestamps) { timestamp.myLODHiddenMask = 0; }
+		if (anInput.contains("lodLevels"))
+		{
+			for (auto& lodLevel : anInput["lodLevels"])
 			{
-				assert(false && "default.kittyVFX not found! attempted to load %s");
+				if (aSequence.myLODLevels.size() >= VFX_MAX_LOD_LEVELS) { break; }
+
+				VFXLODLevel& lod = aSequence.myLODLevels.emplace_back();
+				lod.myDistance = lodLevel["distance"];
+				lod.myParticleMultiplier = lodLevel["particleMultiplier"];
+				for (const int ts : lodLevel["hiddenTimestamps"].get<std::vector<int>>())
+				{
+					aSequence.SetTimestampHidden((int)aSequence.myLODLevels.size(), ts, true);
+				}
 			}
+			aSequence.SortLODLevels();
 		}
 
-		file >> input;
-		file.close();
-		
-		sq.myDuration = input["duration"];
-		
-		sq.myVFXMeshes.reserve(32); //temp!? TODO: fix
+		aSequence.myBudget = anInput.contains("budget") ? VFXBudgetFromJson(anInput["budget"]) : VFXBudget{};
 
-		
+		aSequence.myCustomAttributes.clear();
+		if (anInput.contains("customAttributes"))
+		{
+			for (auto& attribute : anInput["customAttributes"])
+			{
+				if (!aSequence.AddCustomAttribute(attribute["name"], attribute["default"]))
+				{
+					KE_ERROR("Dropped custom attribute %s of sequence %s", attribute["name"].get<std::string>().c_str(), aSequence.myName.c_str());
+				}
+			}
+		}
+	}
 
-		//load meshes
-		for (auto& mesh : input["meshes"])
+	void VFXManager::HashVFXSequenceSource(VFXSequenceSource& aSource, const nlohmann::json& aSequenceData)
+	{
+		aSource.myMeshHashes.clear();
+		aSource.myEmitterResourceHashes.clear();
+		aSource.myEmitterAttributeHashes.clear();
+		aSource.myTimestampHashes.clear();
+
+		for (auto& mesh : aSequenceData["meshes"])
 		{
-			VFXMeshInstance& meshData = sq.myVFXMeshes.emplace_back();
-			meshData.myModelData.myMeshList = &myGraphics->GetModelLoader().Load(mesh["name"]);
-			meshData.myModelData.myRenderResources.emplace_back();
-			meshData.myModelData.myRenderResources[0].myMaterial = myGraphics->GetTextureLoader().GetCustomMaterial(
-				mesh["albedo"],
-				mesh["normal"],
-				mesh["material"],
-				mesh["effects"]
-			);
+			aSource.myMeshHashes.push_back(HashVFXSection(mesh));
+		}
+		for (auto& emitter : aSequenceData["particleEmitters"])
+		{
+			aSource.myEmitterResourceHashes.push_back(HashVFXEmitterResources(emitter));
+			aSource.myEmitterAttributeHashes.push_back(HashVFXSection(emitter));
+		}
+		for (auto& timestamp : aSequenceData["timestamps"])
+		{
+			aSource.myTimestampHashes.push_back(HashVFXSection(timestamp));
+		}
+	}
+
+	size_t VFXManager::HashVFXSection(const nlohmann::json& aSection)
+	{
+		return std::hash<std::string>{}(aSection.dump());
+	}
+
+	size_t VFXManager::HashVFXEmitterResources(const nlohmann::json& anEmitterData)
+	{
+		return HashVFXSection({ anEmitterData["particleCapacity"], anEmitterData["particleTexture"] });
+	}
+
+	bool VFXManager::ReloadVFXSequence(int aVFXSequenceIndex)
+	{
+		return RequestReload(aVFXSequenceIndex, VFXReloadMode::Changed);
+	}
+
+	void VFXManager::RevertVFXSequence(int aVFXSequenceIndex)
+	{
+		RequestReload(aVFXSequenceIndex, VFXReloadMode::Full);
+	}
+
+	bool VFXManager::RequestReload(int aVFXSequenceIndex, VFXReloadMode aMode)
+	{
+		if (!myIsPipelined) { return ApplyReload(aVFXSequenceIndex, aMode); }
+
+		//the packages already built this update point into the meshes a reload retires, EndFrame rebuilds them once for every reload
+		if (mySequenceSources.size() <= aVFXSequenceIndex) { mySequenceSources.resize(aVFXSequenceIndex + 1); }
+		VFXReloadMode& pending = mySequenceSources[aVFXSequenceIndex].myPendingReload;
+		pending = std::max(pending, aMode);
+		return true;
+	}
+
+	bool VFXManager::ApplyPendingReloads()
+	{
+		bool isApplied = false;
+		for (int i = 0; i < mySequenceSources.size(); i++)
+		{
+			const VFXReloadMode mode = std::exchange(mySequenceSources[i].myPendingReload, VFXReloadMode::None);
+			if (mode == VFXReloadMode::None) { continue; }
 
-			meshData.myModelData.myRenderResources[0].myVertexShader = myGraphics->GetShaderLoader().GetVertexShader(mesh["vertexShader"]);
-			meshData.myModelData.myRenderResources[0].myPixelShader = myGraphics->GetShaderLoader().GetPixelShader(mesh["pixelShader"]);
-			meshData.myModelData.myTransform = &meshData.myTransform.GetMatrix();
+			ApplyReload(i, mode);
+			isApplied = true;
 		}
+		return isApplied;
+	}
 
-		//load particle emitters
-		for (auto& emitter : input["particleEmitters"])
+	void VFXManager::RebuildRenderSnapshot()
+	{
+		//the packages built this update point at the retired meshes from before the reload
+		myRenderSnapshots[myWriteSnapshot].myRenderPackages.clear();
+		for (auto& playerData : myRenderQueue)
 		{
-			VFXEmitter& emit = sq.myParticleEmitters.emplace_back();
-			auto& em = emit.myEmitter;
+			PrepareRenderData(playerData);
+		}
+		for (auto& sharedSimulation : mySharedSimulations)
+		{
+			PrepareSharedRenderData(sharedSimulation);
+		}
 
-			em.Init(myGraphics, emitter["particleCapacity"], emitter["particleTexture"]);
+		BuildSpriteBatchGroups();
+		GatherBloomContributors();
+		BuildViewSubmissions();
+	}
+
+	bool VFXManager::ApplyReload(int aVFXSequenceIndex, VFXReloadMode aMode)
+	{
+		KE_VFX_PROFILE_SCOPE(myProfiler, "Reload Sequence");
+
+		VFXSequence& sq = myVFXSequences[aVFXSequenceIndex];
+		if (aMode == VFXReloadMode::Full || mySequenceSources.size() <= aVFXSequenceIndex || mySequenceSources[aVFXSequenceIndex].myFilePath.empty())
+		{
+			LoadVFXSequence(aVFXSequenceIndex, sq.myName);
 
-			em.GetSpriteBatch()->myData.myMode = (SpriteBatchMode)emitter["particleMode"];
+			//every template was rebuilt, none of the live players' emitter copies can be kept
+			const std::vector<bool> rebuilt(sq.myParticleEmitters.size(), true);
+			PatchLivePlayers(aVFXSequenceIndex, rebuilt, rebuilt);
+			return true;
+		}
 
-			auto& attr = em.GetSharedAttributes();
-			auto& spa = emitter["sharedParticleAttributes"];
+		VFXSequenceSource& source = mySequenceSources[aVFXSequenceIndex];
+		std::ifstream file(source.myFilePath);
+		nlohmann::json input = file.is_open() ? nlohmann::json::parse(file, nullptr, false) : nlohmann::json();
+		if (input.is_discarded() || !input.is_object())
+		{
+			//editors save in several writes, a half written file just gets picked up on the next poll
+			return false;
+		}
+		source.myWriteTime = std::filesystem::last_write_time(source.myFilePath);
+
+		//meshes, only the ones whose json changed get their resources resolved again
+		const nlohmann::json& meshes = input["meshes"];
+		std::vector<VFXMeshInstance> reloadedMeshes = sq.myVFXMeshes;
+		RetireMeshes(sq);
+		sq.myVFXMeshes = std::move(reloadedMeshes);
+		sq.myVFXMeshes.resize(meshes.size());
+		source.myMeshHashes.resize(meshes.size(), 0);
+		for (int i = 0; i < meshes.size(); i++)
+		{
+			const size_t hash = HashVFXSection(meshes[i]);
+			if (hash == source.myMeshHashes[i]) { continue; }
 
-			attr.burstTimeMin = spa["burstTimeMin"];
-			attr.burstTimeMax = spa["burstTimeMax"];
-			attr.burstCountMin = spa["burstCountMin"];
-			attr.burstCountMax = spa["burstCountMax"];
+			LoadVFXMesh(sq.myVFXMeshes[i], meshes[i]);
+			source.myMeshHashes[i] = hash;
+		}
+		for (VFXMeshInstance& mesh : sq.myVFXMeshes)
+		{
+			//the copy and the resize move the meshes, their model data points back at their own transform
+			mesh.myModelData.myTransform = &mesh.myTransform.GetMatrix();
+		}
 
-			attr.velocityMin = spa["velocityMin"];
-			attr.velocityMax = spa["velocityMax"];
+		//emitters, textures and capacity need a new sprite batch while the attributes can be patched in place
+		const nlohmann::json& emitters = input["particleEmitters"];
+		std::vector<bool> emitterResourcesChanged(emitters.size(), false);
+		std::vector<bool> emitterAttributesChanged(emitters.size(), false);
 
-			attr.accelerationMin = spa["accelerationMin"];
-			attr.accelerationMax = spa["accelerationMax"];
+		sq.myParticleEmitters.resize(emitters.size());
+		source.myEmitterResourceHashes.resize(emitters.size(), 0);
+		source.myEmitterAttributeHashes.resize(emitters.size(), 0);
+		for (int i = 0; i < emitters.size(); i++)
+		{
+			const size_t resourceHash = HashVFXEmitterResources(emitters[i]);
+			const size_t attributeHash = HashVFXSection(emitters[i]);
+			ParticleEmitter& emitter = sq.myParticleEmitters[i].myEmitter;
 
-			attr.velocityDegradation = spa["velocityDegradation"];
-			attr.accelerationDegradation = spa["accelerationDegradation"];
+			if (resourceHash != source.myEmitterResourceHashes[i])
+			{
+				LoadVFXEmitterResources(emitter, emitters[i]);
+				source.myEmitterResourceHashes[i] = resourceHash;
+				source.myEmitterAttributeHashes[i] = 0;
+				emitterResourcesChanged[i] = true;
+				myParticleAtlasDirty = true;
+			}
+			if (attributeHash != source.myEmitterAttributeHashes[i])
+			{
+				LoadVFXEmitterAttributes(emitter, emitters[i]);
+				source.myEmitterAttributeHashes[i] = attributeHash;
+				emitterAttributesChanged[i] = true;
+			}
+		}
 
-			attr.lifeTimeMin = spa["lifeTimeMin"];
-			attr.lifeTimeMax = spa["lifeTimeMax"];
-			attr.lifeTimeMidPoint = spa["lifeTimeMidPoint"];
+		//timestamps
+		const nlohmann::json& timestamps = input["timestamps"];
+		sq.myTimestamps.resize(timestamps.size());
+		source.myTimestampHashes.resize(timestamps.size(), 0);
+		for (int i = 0; i < timestamps.size(); i++)
+		{
+			const size_t hash = HashVFXSection(timestamps[i]);
+			if (hash == source.myTimestampHashes[i]) { continue; }
 
-			attr.angleMin = spa["angleMin"];
-			attr.angleMax = spa["angleMax"];
+			LoadVFXTimestamp(sq.myTimestamps[i], timestamps[i]);
+			source.myTimestampHashes[i] = hash;
+		}
 
-			attr.horizontalVelocityFactor = spa["horizontalVelocityFactor"];
-			attr.verticalVelocityFactor = spa["verticalVelocityFactor"];
+		LoadVFXSequenceSettings(sq, input);
+		sq.myRevision++;
+		MarkVFXSequenceLoaded(aVFXSequenceIndex);
 
-			attr.startColor = Vector4f(spa["startColor"][0], spa["startColor"][1], spa["startColor"][2], spa["startColor"][3]);
-			attr.midColor = Vector4f(spa["midColor"][0], spa["midColor"][1], spa["midColor"][2], spa["midColor"][3]);
-			attr.endColor = Vector4f(spa["endColor"][0], spa["endColor"][1], spa["endColor"][2], spa["endColor"][3]);
+		PatchLivePlayers(aVFXSequenceIndex, emitterResourcesChanged, emitterAttributesChanged);
+		return true;
+	}
 
-			attr.startSize = spa["startSize"];
-			attr.midSize = spa["midSize"];
-			attr.endSize = spa["endSize"];
+	void VFXManager::PatchLivePlayers(int aVFXSequenceIndex, const std::vector<bool>& someResourcesChanged, const std::vector<bool>& someAttributesChanged)
+	{
+		for (auto& playerData : myRenderQueue)
+		{
+			if (playerData.mySequenceIndex == aVFXSequenceIndex) { PatchLivePlayer(playerData, someResourcesChanged, someAttributesChanged); }
+		}
+		for (auto& sharedSimulation : mySharedSimulations)
+		{
+			VFXSequencePlayerData& playerData = sharedSimulation.myPlayerData;
+			if (playerData.mySequenceIndex == aVFXSequenceIndex) { PatchLivePlayer(playerData, someResourcesChanged, someAttributesChanged); }
 		}
+	}
 
-		//load timestamps
-		for (auto& timestamp : input["timestamps"])
+	void VFXManager::PatchLivePlayer(VFXSequencePlayerData& aPlayerData, const std::vector<bool>& someResourcesChanged, const std::vector<bool>& someAttributesChanged)
+	{
+		//the player keeps its timeline, emitter copies that can't be patched are dropped and residency acquires them fresh
+		VFXSequence& sq = myVFXSequences[aPlayerData.mySequenceIndex];
+		aPlayerData.myLODLevel = std::min(aPlayerData.myLODLevel, (int)sq.myLODLevels.size());
+
+		std::erase_if(aPlayerData.myEmitters, [&](const VFXEmitter& anEmitter)
 		{
-			VFXTimeStamp& ts = sq.myTimestamps.emplace_back();
-			ts.myType = (VFXType)timestamp["type"];
-			ts.myStartpoint = timestamp["start"];
-			ts.myEndpoint = timestamp["end"];
-			ts.myEffectIndex = timestamp["effectIndex"];
+			const int ts = anEmitter.myTimestampIndex;
+			return ts >= sq.myTimestamps.size() ||
+				sq.myTimestamps[ts].myType != VFXType::ParticleEmitter ||
+				sq.myTimestamps[ts].myEffectIndex != anEmitter.myTemplateIndex ||
+				anEmitter.myTemplateIndex >= someResourcesChanged.size() ||
+				someResourcesChanged[anEmitter.myTemplateIndex];
+		});
+
+		for (VFXEmitter& emitter : aPlayerData.myEmitters)
+		{
+			VFXEmitter& source = sq.myParticleEmitters[emitter.myTemplateIndex];
+			emitter.myStartFrame = sq.myTimestamps[emitter.myTimestampIndex].myStartpoint;
+			emitter.myEndFrame = sq.myTimestamps[emitter.myTimestampIndex].myEndpoint;
 
-			if (ts.myType == VFXType::ParticleEmitter)
+			if (someAttributesChanged[emitter.myTemplateIndex])
 			{
-				sq.myParticleEmitters[ts.myEffectIndex].myStartFrame = ts.myStartpoint;
-				sq.myParticleEmitters[ts.myEffectIndex].myEndFrame = ts.myEndpoint;
+				emitter.myEmitter.GetSharedAttributes() = source.myEmitter.GetSharedAttributes();
+				emitter.myEmitter.GetSpriteBatch()->myData.myMode = source.myEmitter.GetSpriteBatch()->myData.myMode;
 			}
+			ApplyLODToEmitter(emitter, sq, aPlayerData.myLODLevel);
+		}
 
-			for (auto& curve : timestamp["curves"])
-			{
-				int index = (int)curve["curveAttribute"];
-				if (index >= (int)VFXAttributeTypes::Count) { continue; }
+		UpdateEmitterResidency(aPlayerData);
+	}
+
+	void VFXManager::SetHotReloadEnabled(bool anIsEnabled)
+	{
+		myIsHotReloadEnabled = anIsEnabled;
+		myHotReloadTimer = 0.0f;
+	}
 
-				VFXCurveDataSet& cd = ts.myCurveDataSets[index];
-				cd.myType = (VFXAttributeTypes)curve["curveAttribute"];
-				cd.myCurveProfile = (VFXCurveProfiles)curve["curveProfile"];
-				cd.myMinValue = curve["minValue"];
-				cd.myMaxValue = curve["maxValue"];
+	void VFXManager::DispatchSaveResults()
+	{
+		for (VFXSaveResult& result : mySequenceSaver.DispatchResults())
+		{
+			if (result.status != VFXSaveStatus::Written || result.sequenceIndex >= mySequenceSources.size()) { continue; }
 
-				for (auto& point : curve["points"])
-				{
-					cd.myData.push_back(Vector2f(point["x"], point["y"]));
-				}
+			VFXSequenceSource& source = mySequenceSources[result.sequenceIndex];
+			if (source.myFilePath != result.filePath) { continue; }
+
+			//a later save can already be writing the file, its own result moves the write time on again
+			std::error_code error;
+			source.myWriteTime = std::filesystem::last_write_time(source.myFilePath, error);
+			HashVFXSequenceSource(source, result.snapshot);
+		}
+	}
+
+	void VFXManager::PollHotReload(float aDeltaTime)
+	{
+		myHotReloadTimer += aDeltaTime;
+		if (myHotReloadTimer < VFX_HOT_RELOAD_INTERVAL) { return; }
+		myHotReloadTimer = 0.0f;
+
+		DispatchSaveResults();
+		for (int i = 0; i < mySequenceSources.size(); i++)
+		{
+			const VFXSequenceSource& source = mySequenceSources[i];
+			if (source.myFilePath.empty()) { continue; }
+
+			//our own save, the write time is taken over once its result is dispatched
+			if (mySequenceSaver.IsSaving(i)) { continue; }
+
+			std::error_code error;
+			const auto writeTime = std::filesystem::last_write_time(source.myFilePath, error);
+			if (!error && writeTime != source.myWriteTime)
+			{
+				ReloadVFXSequence(i);
 			}
 		}
 	}
 
+	bool VFXManager::MountVFXPack(const std::string& aPackPath)
+	{
+		return myPack.Open(aPackPath);
+	}
+
+	void VFXManager::UnmountVFXPack()
+	{
+		myPack.Close();
+	}
+
 	int VFXManager::CreateVFXSequence(const std::string& aName)
+	{
+		const int index = AddVFXSequence(aName);
+		LoadVFXSequence(index, aName);
+		myResidency[index].myIsEvictable = true;
+
+		return index;
+	}
+
+	int VFXManager::AddVFXSequence(const std::string& aName)
 	{
 		VFXSequence& sq = myVFXSequences.emplace_back();
 
 		sq.myIndex = (int)myVFXSequences.size() - 1;
 		sq.myManager = this;
-		LoadVFXSequence(sq.myIndex, aName);
-
 		sq.myName = aName;
+		myResidency.emplace_back().myLastUsedFrame = myResidencyFrame;
 
 		return sq.myIndex;
 	}
@@ -584,16 +2242,261 @@ namespace KE
 
 	VFXSequence* VFXManager::GetVFXSequence(int aVFXSequenceIndex)
 	{
+		EnsureVFXSequenceResident(aVFXSequenceIndex);
 		return &myVFXSequences[aVFXSequenceIndex];
 	}
 
+	void VFXManager::AcquireVFXSequence(int aVFXSequenceIndex)
+	{
+		myResidency[aVFXSequenceIndex].myHolderCount++;
+	}
+
+	void VFXManager::ReleaseVFXSequence(int aVFXSequenceIndex)
+	{
+		VFXSequenceResidency& residency = myResidency[aVFXSequenceIndex];
+		assert(residency.myHolderCount > 0 && "VFX sequence released more often than it was acquired");
+
+		residency.myHolderCount--;
+		residency.myLastUsedFrame = myResidencyFrame;
+	}
+
+	void VFXManager::EnsureVFXSequenceResident(int aVFXSequenceIndex)
+	{
+		VFXSequenceResidency& residency = myResidency[aVFXSequenceIndex];
+		residency.myLastUsedFrame = myResidencyFrame;
+		if (residency.myIsResident) { return; }
+
+		KE_VFX_PROFILE_SCOPE(myProfiler, "Reload Evicted Sequence");
+		LoadVFXSequence(aVFXSequenceIndex, myVFXSequences[aVFXSequenceIndex].myName);
+		myResidencyStats.myReloads++;
+	}
+
+	void VFXManager::MarkVFXSequenceLoaded(int aVFXSequenceIndex)
+	{
+		VFXSequenceResidency& residency = myResidency[aVFXSequenceIndex];
+		residency.myIsResident = true;
+		residency.myLastUsedFrame = myResidencyFrame;
+		residency.myBytes = GetSequenceBytes(myVFXSequences[aVFXSequenceIndex]).GetTotal();
+	}
+
+	void VFXManager::EvictVFXSequence(int aVFXSequenceIndex)
+	{
+		VFXSequence& sq = myVFXSequences[aVFXSequenceIndex];
+
+		//assigned rather than cleared so the capacity goes too, name and index stay for the reload
+		RetireMeshes(sq);
+		sq.myVFXMeshes = {};
+		sq.myParticleEmitters = {};
+		sq.myTimestamps = {};
+		sq.myLODLevels = {};
+		sq.myCustomAttributes = {};
+		sq.myRevision++;
+
+		//nothing left to hot reload, the next use reads the file again anyway
+		if (aVFXSequenceIndex < mySequenceSources.size()) { mySequenceSources[aVFXSequenceIndex] = {}; }
+
+		VFXSequenceResidency& residency = myResidency[aVFXSequenceIndex];
+		residency.myIsResident = false;
+		residency.myBytes = 0;
+
+		myParticleAtlasDirty = true;
+		myResidencyStats.myEvictions++;
+	}
+
+	void VFXManager::UpdateResidency()
+	{
+		myResidencyFrame++;
+
+		for (VFXSequenceResidency& residency : myResidency) { residency.myPlayerCount = 0; }
+		const auto countPlayer = [this](const VFXSequencePlayerData& aPlayerData)
+		{
+			VFXSequenceResidency& residency = myResidency[aPlayerData.mySequenceIndex];
+			residency.myPlayerCount++;
+			residency.myLastUsedFrame = myResidencyFrame;
+		};
+		std::ranges::for_each(myRenderQueue, countPlayer);
+		for (const auto& sharedSimulation : mySharedSimulations) { countPlayer(sharedSimulation.myPlayerData); }
+
+		size_t residentBytes = 0;
+		for (const VFXSequenceResidency& residency : myResidency)
+		{
+			if (residency.myIsResident) { residentBytes += residency.myBytes; }
+		}
+
+		while (residentBytes > myResidencyBudget)
+		{
+			int oldest = -1;
+			for (int i = 0; i < myResidency.size(); i++)
+			{
+				const VFXSequenceResidency& residency = myResidency[i];
+				if (!residency.myIsResident || !residency.myIsEvictable || residency.myHolderCount > 0 || residency.myPlayerCount > 0) { continue; }
+
+				//the published snapshot can still point at the meshes of a sequence that stopped last frame
+				if (myResidencyFrame - residency.myLastUsedFrame < VFX_RESIDENCY_GRACE_FRAMES) { continue; }
+
+				if (oldest < 0 || residency.myLastUsedFrame < myResidency[oldest].myLastUsedFrame) { oldest = i; }
+			}
+
+			//everything left is in use, the budget is exceeded until some of it stops
+			if (oldest < 0) { break; }
+
+			residentBytes -= myResidency[oldest].myBytes;
+			EvictVFXSequence(oldest);
+		}
+	}
+
+	const VFXResidencyStats& VFXManager::GetResidencyStats()
+	{
+		VFXResidencyStats& stats = myResidencyStats;
+		stats.myResidentCount = 0;
+		stats.myEvictedCount = 0;
+		stats.myResidentBytes = 0;
+		stats.myBudget = myResidencyBudget;
+
+		for (const VFXSequenceResidency& residency : myResidency)
+		{
+			if (residency.myIsResident)
+			{
+				stats.myResidentCount++;
+				stats.myResidentBytes += residency.myBytes;
+			}
+			else
+			{
+				stats.myEvictedCount++;
+			}
+		}
+		return stats;
+	}
+
+	size_t VFXManager::GetPackageCacheBytes(const VFXPackageCache& aCache)
+	{
+		return aCache.myPackages.capacity() * sizeof(VFXSequenceRenderPackage) + aCache.myTimestamps.capacity() * sizeof(int);
+	}
+
+	size_t VFXManager::GetEmitterBytes(std::vector<VFXEmitter>& anEmitters)
+	{
+		size_t bytes = anEmitters.capacity() * sizeof(VFXEmitter);
+		for (auto& emitter : anEmitters)
+		{
+			const auto& instances = emitter.myEmitter.GetSpriteBatch()->myInstances;
+			bytes += instances.capacity() * sizeof(instances[0]);
+		}
+		return bytes;
+	}
+
+	VFXMemoryUsage VFXManager::GetSequenceBytes(VFXSequence& aSequence)
+	{
+		VFXMemoryUsage usage;
+		VFXSequence& sq = aSequence;
+		auto& bytes = usage.myBytes;
+
+		bytes[(int)VFXMemoryCategory::Timestamps] += sq.myTimestamps.capacity() * sizeof(VFXTimeStamp) + sq.myLODLevels.capacity() * sizeof(VFXLODLevel);
+		for (auto& timestamp : sq.myTimestamps)
+		{
+			for (auto& curve : timestamp.myCurveDataSets)
+			{
+				bytes[(int)VFXMemoryCategory::Curves] += curve.myData.capacity() * sizeof(Vector2f);
+			}
+			for (auto& curve : timestamp.myCustomCurveDataSets)
+			{
+				bytes[(int)VFXMemoryCategory::Curves] += curve.myData.capacity() * sizeof(Vector2f);
+			}
+		}
+
+		//model data is owned by the asset system, only our instance data is counted
+		bytes[(int)VFXMemoryCategory::MeshInstances] += sq.myVFXMeshes.capacity() * sizeof(VFXMeshInstance);
+		bytes[(int)VFXMemoryCategory::EmitterTemplates] += GetEmitterBytes(sq.myParticleEmitters);
+		return usage;
+	}
+
+	void VFXManager::UpdateMemoryStats()
+	{
+		VFXMemoryStats& stats = myMemoryStats;
+		stats.mySequences.assign(myVFXSequences.size(), {});
+		stats.mySequencePeaks.resize(myVFXSequences.size(), 0);
+
+		for (int i = 0; i < myVFXSequences.size(); i++)
+		{
+			stats.mySequences[i] = GetSequenceBytes(myVFXSequences[i]);
+		}
+
+		for (auto& playerData : myRenderQueue)
+		{
+			auto& bytes = stats.mySequences[playerData.mySequenceIndex].myBytes;
+			bytes[(int)VFXMemoryCategory::PlayerState] += sizeof(VFXSequencePlayerData) + GetPackageCacheBytes(playerData.myPackageCache);
+			bytes[(int)VFXMemoryCategory::EmitterInstances] += GetEmitterBytes(playerData.myEmitters);
+		}
+
+		for (auto& sharedSimulation : mySharedSimulations)
+		{
+			auto& bytes = stats.mySequences[sharedSimulation.myPlayerData.mySequenceIndex].myBytes;
+			bytes[(int)VFXMemoryCategory::PlayerState] += sizeof(VFXSharedSimulation) + sharedSimulation.myPlacements.capacity() * sizeof(VFXSharedPlacement);
+			bytes[(int)VFXMemoryCategory::PlayerState] += GetPackageCacheBytes(sharedSimulation.myPlayerData.myPackageCache);
+			bytes[(int)VFXMemoryCategory::EmitterInstances] += GetEmitterBytes(sharedSimulation.myPlayerData.myEmitters);
+		}
+
+		VFXMemoryUsage& current = stats.myCurrent;
+		current = {};
+		for (int i = 0; i < stats.mySequences.size(); i++)
+		{
+			const VFXMemoryUsage& sequence = stats.mySequences[i];
+			for (int c = 0; c < (int)VFXMemoryCategory::Count; c++) { current.myBytes[c] += sequence.myBytes[c]; }
+			stats.mySequencePeaks[i] = std::max(stats.mySequencePeaks[i], sequence.GetTotal());
+		}
+
+		//the queues themselves, the slack in their capacity included
+		current.myBytes[(int)VFXMemoryCategory::PlayerState] += (myRenderQueue.capacity() - myRenderQueue.size()) * sizeof(VFXSequencePlayerData);
+		current.myBytes[(int)VFXMemoryCategory::PlayerState] += (mySharedSimulations.capacity() - mySharedSimulations.size()) * sizeof(VFXSharedSimulation);
+
+		for (auto& snapshot : myRenderSnapshots)
+		{
+			size_t& packageBytes = current.myBytes[(int)VFXMemoryCategory::RenderPackages];
+			packageBytes += snapshot.myRenderPackages.capacity() * sizeof(VFXSequenceRenderPackage);
+			packageBytes += snapshot.mySpriteBatchGroups.capacity() * sizeof(VFXSpriteBatchGroup);
+			for (auto& group : snapshot.mySpriteBatchGroups)
+			{
+				packageBytes += group.myBatch.myInstances.capacity() * sizeof(group.myBatch.myInstances[0]);
+			}
+			for (auto& submission : snapshot.myViewSubmissions)
+			{
+				packageBytes += sizeof(VFXViewSubmission) + submission.myPackageIndices.capacity() * sizeof(int);
+			}
+		}
+		current.myBytes[(int)VFXMemoryCategory::RenderPackages] += myViewSortKeys.capacity() * sizeof(float);
+
+		for (int c = 0; c < (int)VFXMemoryCategory::Count; c++)
+		{
+			stats.myPeak.myBytes[c] = std::max(stats.myPeak.myBytes[c], current.myBytes[c]);
+		}
+		stats.myPeakTotal = std::max(stats.myPeakTotal, current.GetTotal());
+	}
+
+	const VFXMemoryStats& VFXManager::GetMemoryStats()
+	{
+		UpdateMemoryStats();
+		return myMemoryStats;
+	}
+
+	void VFXManager::ResetMemoryPeaks()
+	{
+		myMemoryStats.myPeak = myMemoryStats.myCurrent;
+		myMemoryStats.myPeakTotal = myMemoryStats.myCurrent.GetTotal();
+		for (int i = 0; i < myMemoryStats.mySequencePeaks.size(); i++)
+		{
+			myMemoryStats.mySequencePeaks[i] = myMemoryStats.mySequences[i].GetTotal();
+		}
+	}
+
 	void VFXManager::ClearVFX()
 	{
 		myRenderQueue.clear();
+		mySharedSimulations.clear();
 	}
 
-	void VFXManager::RenderVFXDirect(int aVFXIndex, int aCurrentFrame, Transform* aTransform, eRenderLayers aLayer)
+	void VFXManager::RenderVFXDirect(int aVFXIndex, int aCurrentFrame, Transform* aTransform, eRenderLayers aLayer, int aLODLevel, std::span<VFXEmitter> someEmitters)
 	{
+		EnsureVFXSequenceResident(aVFXIndex);
+
 		const VFXRenderInput in(*aTransform, false, false);
 
 		//create a custom player data
@@ -603,7 +2506,55 @@ namespace KE
 		playerData.myRenderInput.myTransform = aTransform;
 		playerData.myTimer = 0.0f;
 		playerData.myLayer = aLayer;
+		playerData.myLODLevel = aLODLevel;
 
 		PrepareRenderData(playerData);
+		for (VFXEmitter& emitter : someEmitters)
+		{
+			AppendToSpriteBatchGroup(*emitter.myEmitter.GetSpriteBatch(), aLayer, nullptr);
+		}
+	}
+
+	VFXPlayerInterface::VFXPlayerInterface(const VFXPlayerInterface& anOther) : manager(anOther.manager), myVFXSequenceIndices(anOther.myVFXSequenceIndices)
+	{
+		for (const int index : myVFXSequenceIndices) { manager->AcquireVFXSequence(index); }
+	}
+
+	VFXPlayerInterface::VFXPlayerInterface(VFXPlayerInterface&& anOther) noexcept : manager(anOther.manager), myVFXSequenceIndices(std::move(anOther.myVFXSequenceIndices))
+	{
+		anOther.myVFXSequenceIndices.clear();
+	}
+
+	VFXPlayerInterface& VFXPlayerInterface::operator=(const VFXPlayerInterface& anOther)
+	{
+		if (this == &anOther) { return *this; }
+
+		Clear();
+		manager = anOther.manager;
+		myVFXSequenceIndices = anOther.myVFXSequenceIndices;
+		for (const int index : myVFXSequenceIndices) { manager->AcquireVFXSequence(index); }
+		return *this;
+	}
+
+	VFXPlayerInterface& VFXPlayerInterface::operator=(VFXPlayerInterface&& anOther) noexcept
+	{
+		if (this == &anOther) { return *this; }
+
+		Clear();
+		manager = anOther.manager;
+		myVFXSequenceIndices = std::move(anOther.myVFXSequenceIndices);
+		anOther.myVFXSequenceIndices.clear();
+		return *this;
+	}
+
+	VFXPlayerInterface::~VFXPlayerInterface()
+	{
+		Clear();
+	}
+
+	void VFXPlayerInterface::Clear()
+	{
+		for (const int index : myVFXSequenceIndices) { manager->ReleaseVFXSequence(index); }
+		myVFXSequenceIndices.clear();
 	}
 }
@@ -1,4 +1,11 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <span>
+#include <unordered_map>
+
+#include <External/Include/nlohmann/json.hpp>
+
 #include "Engine/Source/Graphics/Particle/ParticleEmitter.h"
 
 #include <Editor/Source/EditorInterface.h>
@@ -6,6 +13,12 @@
 #include "Engine/Source/Graphics/PostProcessing.h"
 #include "Engine/Source/Graphics/Renderers/BasicRenderer.h"
 #include "Engine/Source/Graphics/FX/VFXResources.h"
+#include "Engine/Source/Graphics/FX/VFXTextureAtlas.h"
+#include "Engine/Source/Graphics/FX/VFXProfiler.h"
+#include "Engine/Source/Graphics/FX/VFXTrace.h"
+#include "Engine/Source/Graphics/FX/VFXCommandQueue.h"
+#include "Engine/Source/Graphics/FX/VFXSequenceSaver.h"
+#include "Engine/Source/Graphics/FX/VFXPack.h"
 
 namespace KE
 {
@@ -13,6 +26,9 @@ namespace KE
 	class VFXManager
 	{
 		KE_EDITOR_FRIEND
+		friend class VFXBenchmark;
+		friend class VFXTraceReplay;
+		friend class VFXValidation;
 	private:
 		Graphics* myGraphics;
 		SpriteManager* mySpriteManager;
@@ -23,51 +39,264 @@ namespace KE
 
 		//render data
 		std::vector<VFXSequencePlayerData> myRenderQueue;
-		std::vector<VFXSequenceRenderPackage> myRenderPackages;
+		std::vector<VFXSharedSimulation> mySharedSimulations;
 		std::vector<SpriteBatch*> mySpriteBatches;
+
+		//update fills myRenderSnapshots[myWriteSnapshot] and swaps it into the middle at EndFrame. when pipelined the render
+		//thread swaps the newest one out of the middle in BeginRenderFrame, so the two threads never share a buffer
+		std::array<VFXRenderSnapshot, 3> myRenderSnapshots;
+		int myWriteSnapshot = 0;
+		std::atomic<int> myMiddleSnapshot = 1;
+		int myRenderSnapshot = 2; //only touched by the render thread
+		std::atomic<uint64_t> myRenderFence = 0; //counts BeginRenderFrame calls
+		std::vector<VFXRetiredResources> myRetiredResources;
+		bool myIsPipelined = false;
+
+		//views keep their index for as long as they're registered, unregistered slots have no camera
+		std::vector<VFXView> myViews;
+		std::vector<VFXView> myFrameViews;
+		std::vector<float> myViewSortKeys;
+		VFXTextureAtlas myParticleAtlas;
+		bool myParticleAtlasDirty = false;
+		std::vector<VFXRenderInput> myBatchInputs;
+		std::vector<int> myVisibleTimestamps;
+		VFXMemoryStats myMemoryStats;
+		VFXTraceRecorder* myTraceRecorder = nullptr;
+		std::vector<Vector3f> myViewPositionOverrides;
+		std::vector<VFXSequenceSource> mySequenceSources;
+		mutable std::unordered_map<const MeshList*, VFXMeshShape> myMeshShapes;
+		float myHotReloadTimer = 0.0f;
+		bool myIsHotReloadEnabled = false;
+		VFXSequenceSaver mySequenceSaver;
+		VFXPack myPack;
+		std::vector<VFXSequenceResidency> myResidency;
+		VFXResidencyStats myResidencyStats;
+		size_t myResidencyBudget = VFX_DEFAULT_RESIDENCY_BUDGET;
+		uint64_t myResidencyFrame = 0;
 		//
+
+#ifdef KE_VFX_PROFILING
+		VFXProfiler myProfiler;
+#endif
+
+		//handles are reserved from any thread by the enqueue functions
+		std::atomic<VFXInstanceHandle> myNextHandle = 0;
+		VFXCommandQueue myCommandQueue;
+		VFXCommand myDrainCommand;
+		int myEmitterLookahead = VFX_DEFAULT_EMITTER_LOOKAHEAD;
+
+		bool AdvancePlayer(VFXSequencePlayerData& aPlayerData, float aDeltaTime) const;
+		void UpdateLODLevel(VFXSequencePlayerData& aPlayerData, float aCameraDistance);
+		void UpdateEmitterResidency(VFXSequencePlayerData& aPlayerData);
+		void UpdateEmitters(VFXSequencePlayerData& aPlayerData);
+		void SeekPlayer(VFXSequencePlayerData& aPlayerData, int aFrame);
+		static void CatchUpEmitter(VFXEmitter& anEmitter, Transform& aTransform, int aFrame, int aDuration, bool aIsLooping);
+		static void ApplyLODToEmitter(VFXEmitter& anEmitter, VFXSequence& aSequence, int aLODLevel);
+
+		void PrepareSharedRenderData(VFXSharedSimulation& aSharedSimulation);
+		void EvaluateRenderPackageAttributes(VFXSequenceRenderPackage& aPackage, const VFXSequence& aSequence, const VFXTimeStamp& aTimestamp, int aFrame) const;
+		void FinalizeRenderPackage(VFXSequenceRenderPackage& aPackage, VFXMeshInstance& aMesh, VFXRenderInput& aRenderInput) const;
+
+		int GetRenderSnapshotIndex() const;
+		void RetireMeshes(VFXSequence& aSequence);
+		void ReleaseRetiredResources();
+		void RenderPackage(VFXSequenceRenderPackage& aPackage, eRenderLayers aLayer);
+
+		void GatherFrameViews();
+		void GatherBloomContributors();
+		float GetClosestViewDistance(const Vector3f& aPosition) const;
+		void BuildViewSubmissions();
+
+		void BuildSpriteBatchGroups();
+		void AppendToSpriteBatchGroup(SpriteBatch& aSourceBatch, eRenderLayers aLayer, Transform* aPlacement);
+
+		inline VFXInstanceHandle ReserveHandle() { return myNextHandle.fetch_add(1, std::memory_order_relaxed); }
+		void TriggerWithHandle(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput, VFXInstanceHandle aHandle);
+		void ExecuteQueuedCommands();
+		void InitializePlayerData(VFXSequencePlayerData& aPlayerData, int aVFXSequenceIndex, VFXInstanceHandle aHandle);
+		static bool IsSharedRenderInput(const VFXRenderInput& aRenderInput);
+		void AddSharedPlacement(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput, VFXInstanceHandle aHandle);
+
+		void LoadVFXMesh(VFXMeshInstance& aMesh, const nlohmann::json& aMeshData);
+		VFXMeshShape GetMeshShape(const MeshList& aMeshList) const;
+		void LoadVFXEmitterResources(ParticleEmitter& anEmitter, const nlohmann::json& anEmitterData);
+		static void LoadVFXEmitterAttributes(ParticleEmitter& anEmitter, const nlohmann::json& anEmitterData);
+		static void LoadVFXTimestamp(VFXTimeStamp& aTimestamp, const nlohmann::json& aTimestampData);
+		static void LoadVFXSequenceSettings(VFXSequence& aSequence, const nlohmann::json& anInput);
+		static size_t HashVFXSection(const nlohmann::json& aSection);
+		static size_t HashVFXEmitterResources(const nlohmann::json& anEmitterData);
+		bool RequestReload(int aVFXSequenceIndex, VFXReloadMode aMode);
+		bool ApplyReload(int aVFXSequenceIndex, VFXReloadMode aMode);
+		bool ApplyPendingReloads();
+		void RebuildRenderSnapshot();
+		void PatchLivePlayers(int aVFXSequenceIndex, const std::vector<bool>& someResourcesChanged, const std::vector<bool>& someAttributesChanged);
+		void PatchLivePlayer(VFXSequencePlayerData& aPlayerData, const std::vector<bool>& someResourcesChanged, const std::vector<bool>& someAttributesChanged);
+		void PollHotReload(float aDeltaTime);
+		static void HashVFXSequenceSource(VFXSequenceSource& aSource, const nlohmann::json& aSequenceData);
+
+		void EnsureVFXSequenceResident(int aVFXSequenceIndex);
+		void MarkVFXSequenceLoaded(int aVFXSequenceIndex);
+		void EvictVFXSequence(int aVFXSequenceIndex);
+		void UpdateResidency();
+
+		void UpdateMemoryStats();
+		static VFXMemoryUsage GetSequenceBytes(VFXSequence& aSequence);
+		static size_t GetEmitterBytes(std::vector<VFXEmitter>& anEmitters);
+		static size_t GetPackageCacheBytes(const VFXPackageCache& aCache);
+
+#ifdef KE_VFX_PROFILING
+		static void AddEmitterCost(VFXSequenceCostSample& aSample, VFXSequencePlayerData& aPlayerData, int aPlacementCount);
+		static void AddPackageCost(VFXSequenceCostSample& aSample, std::span<const VFXSequenceRenderPackage> somePackages);
+#endif
 	public:
 
 
 		void Init(Graphics* aGraphics);
-		void RenderVFX(const VFXBufferData& aFxBuffer, const ModelData* aModelData);
-		void Render(eRenderLayers aLayer, ID3D11DepthStencilView* aDSV);
+		void RenderVFX(const VFXBufferData& aFxBuffer, const ModelData* aModelData, const VFXMeshPasses& aPasses = {});
+		void Render(eRenderLayers aLayer, ID3D11DepthStencilView* aDSV, int aViewIndex = 0);
 		void Update(float aDeltaTime);
 		void Resize(int aWidth, int aHeight);
 
 		void EndFrame();
+		//render thread, once per frame before any Render, ShouldRunBloom or GetBloomScissorRect. every call until the next
+		//one reads the same frame
+		void BeginRenderFrame();
+
+		int RegisterView(Camera* aCamera, float aCullDistance = FLT_MAX);
+		void UnregisterView(int aViewIndex);
+		void SetPipelinedRendering(bool aIsPipelined);
+		inline bool IsPipelinedRendering() const { return myIsPipelined; }
+
+		//replays place the views where they were recorded, an empty span goes back to the cameras
+		inline void SetViewPositionOverrides(std::span<const Vector3f> aPositions) { myViewPositionOverrides.assign(aPositions.begin(), aPositions.end()); }
+		inline void SetTraceRecorder(VFXTraceRecorder* aRecorder) { myTraceRecorder = aRecorder; }
 
 		void PrepareRenderData(VFXSequencePlayerData& aPlayerData);
+		void ApplyLODLevel(VFXSequencePlayerData& aPlayerData, int aLODLevel);
+
+		inline void SetEmitterLookahead(int aLookaheadFrames) { myEmitterLookahead = std::max(aLookaheadFrames, 0); }
+		inline int GetEmitterLookahead() const { return myEmitterLookahead; }
 
 		void InitializeVFXMesh(VFXMeshInstance& aMeshToInitialize) const;
+		void AnalyzeVFXMesh(VFXMeshInstance& aMesh) const; //after the mesh's model was swapped
 		void InitializeParticleEmitter(ParticleEmitter& anEmitterToInitialize) const;
+		void BuildParticleAtlas();
+		inline const VFXTextureAtlas& GetParticleAtlas() const { return myParticleAtlas; }
 		
 		inline PostProcessing& GetPostProcessing() { return myVFXPostProcessing; }
 
-		void TriggerVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput);
+		//whoever runs the post processing asks per view, nothing blooming means the whole chain can be skipped.
+		//the rect is in full resolution pixels, GetVFXDownsampledRect gives it for the smaller targets
+		bool ShouldRunBloom(int aViewIndex = 0) const;
+		VFXScreenRect GetBloomScissorRect(int aViewIndex = 0) const;
+#ifdef KE_VFX_PROFILING
+		inline VFXProfiler& GetProfiler() { return myProfiler; }
+		inline bool DumpProfilerTrace(const std::string& aFilePath) const { return myProfiler.DumpChromeTrace(aFilePath); }
+
+		//most expensive sequences first by cpu time, a negative count returns every sequence seen in the window
+		std::vector<VFXSequenceCost> GetSequenceCosts(int aTopCount = -1) const;
+#endif
+		//measures the current usage on every call, peaks are also sampled every update in builds with the profiler
+		const VFXMemoryStats& GetMemoryStats();
+		void ResetMemoryPeaks();
+
+		inline const std::vector<VFXSpriteBatchGroup>& GetSpriteBatchGroups() const { return myRenderSnapshots[GetRenderSnapshotIndex()].mySpriteBatchGroups; }
+
+		VFXInstanceHandle TriggerVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput);
+		std::vector<VFXInstanceHandle> TriggerVFXSequenceBatch(int aVFXSequenceIndex, std::span<const VFXRenderInput> aRenderInputs);
+		std::vector<VFXInstanceHandle> TriggerVFXSequenceBatch(int aVFXSequenceIndex, std::span<Transform> aTransforms, const VFXRenderInput& aRenderInput);
 		void StopVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput);
+		void StopVFXInstance(VFXInstanceHandle aHandle);
+		void SetInstanceTransform(VFXInstanceHandle aHandle, const Transform& aTransform);
+
+		//safe from any thread, the commands run in the order they were enqueued at the start of the next update.
+		//the handle is valid right away, a full queue returns VFX_INVALID_HANDLE or false and the caller can retry next frame
+		VFXInstanceHandle EnqueueTrigger(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput);
+		bool EnqueueStop(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput);
+		bool EnqueueStopInstance(VFXInstanceHandle aHandle);
+		bool EnqueueSetTransform(VFXInstanceHandle aHandle, const Transform& aTransform);
 
+		//meshes land exactly on the frame, emitters are caught up over their last lifetime in VFX_PREWARM_STEP steps using
+		//the emitter's own rng. the particle distribution is right but not deterministic, two seeks to the same frame differ
+		void Seek(VFXInstanceHandle aHandle, int aFrame);
+		//copies the sequence's emitter templates into someOutEmitters and catches the copies up to the frame
+		void PrewarmSequenceEmitters(int aVFXSequenceIndex, int aFrame, Transform& aTransform, std::vector<VFXEmitter>& someOutEmitters);
+
+		static nlohmann::json SerializeVFXSequence(VFXSequence& aSequence);
 		static void SaveVFXSequence(VFXSequence* aSequence);
+		void SaveVFXSequenceAsync(VFXSequence* aSequence);
+		inline VFXSequenceSaver& GetSequenceSaver() { return mySequenceSaver; }
+		//dispatches the saver's results, a sequence saved over the file it was loaded from takes the save as its source
+		//so hot reload doesn't load it back over the open sequence
+		void DispatchSaveResults();
 		void LoadVFXSequence(int aVFXSequenceIndex, const std::string& aFilePath);
 
+		//rebuilds only the meshes, emitters and timestamps that changed on disk, live players keep their timeline.
+		//returns false if the file couldn't be parsed, the sequence is left as it was. the diff is against what was
+		//loaded, not against edits made since, so this is for the file watcher.
+		//when pipelined both reloads are applied at the next EndFrame and always return true
+		bool ReloadVFXSequence(int aVFXSequenceIndex);
+		//loads the whole sequence from disk again, dropping any unsaved edits. live players keep their timeline
+		void RevertVFXSequence(int aVFXSequenceIndex);
+		void SetHotReloadEnabled(bool anIsEnabled);
+		inline bool IsHotReloadEnabled() const { return myIsHotReloadEnabled; }
+
+		//sequences found in a mounted pack are loaded from it instead of their loose file
+		bool MountVFXPack(const std::string& aPackPath);
+		void UnmountVFXPack();
+		inline const VFXPack& GetPack() const { return myPack; }
+
 		int CreateVFXSequence(const std::string& aName);
+		int AddVFXSequence(const std::string& aName); //empty sequence that isn't backed by a file
 
 		int GetVFXSequenceFromName(const std::string& aName);
-		VFXSequence* GetVFXSequence(int aVFXSequenceIndex);
+		VFXSequence* GetVFXSequence(int aVFXSequenceIndex); //loads the sequence again if it was evicted
+		inline const std::string& GetVFXSequenceName(int aVFXSequenceIndex) const { return myVFXSequences[aVFXSequenceIndex].myName; }
 		void ClearVFX();
 
-		void RenderVFXDirect(int aVFXIndex, int aCurrentFrame, Transform* aTransform, eRenderLayers aLayer);
+		//held sequences are never evicted, unheld ones without live players are unloaded least recently used first
+		//once the resident ones go over the budget, and come back on their next trigger or GetVFXSequence
+		void AcquireVFXSequence(int aVFXSequenceIndex);
+		void ReleaseVFXSequence(int aVFXSequenceIndex);
+		inline void SetResidencyBudget(size_t aBytes) { myResidencyBudget = aBytes; }
+		inline size_t GetResidencyBudget() const { return myResidencyBudget; }
+		inline bool IsVFXSequenceResident(int aVFXSequenceIndex) const { return myResidency[aVFXSequenceIndex].myIsResident; }
+		const VFXResidencyStats& GetResidencyStats();
+
+		//someEmitters are drawn along with the meshes, the editor's preview keeps its own copies
+		void RenderVFXDirect(int aVFXIndex, int aCurrentFrame, Transform* aTransform, eRenderLayers aLayer, int aLODLevel = 0, std::span<VFXEmitter> someEmitters = {});
 	};
 
+	//holds a reference to every sequence it was given, copies hold their own
 	struct VFXPlayerInterface
 	{
-		VFXManager* manager;
+		VFXManager* manager = nullptr;
 
 		std::vector<int> myVFXSequenceIndices;
 
-		void TriggerVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput) const
+		VFXPlayerInterface() = default;
+		VFXPlayerInterface(VFXManager* aManager) : manager(aManager) {}
+		VFXPlayerInterface(const VFXPlayerInterface& anOther);
+		VFXPlayerInterface(VFXPlayerInterface&& anOther) noexcept;
+		VFXPlayerInterface& operator=(const VFXPlayerInterface& anOther);
+		VFXPlayerInterface& operator=(VFXPlayerInterface&& anOther) noexcept;
+		~VFXPlayerInterface();
+
+		void Clear();
+
+		VFXInstanceHandle TriggerVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput) const
+		{
+			return manager->TriggerVFXSequence(myVFXSequenceIndices[aVFXSequenceIndex], aRenderInput);
+		}
+
+		std::vector<VFXInstanceHandle> TriggerVFXSequenceBatch(int aVFXSequenceIndex, std::span<Transform> aTransforms, const VFXRenderInput& aRenderInput) const
+		{
+			return manager->TriggerVFXSequenceBatch(myVFXSequenceIndices[aVFXSequenceIndex], aTransforms, aRenderInput);
+		}
+
+		VFXInstanceHandle EnqueueTrigger(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput) const
 		{
-			manager->TriggerVFXSequence(myVFXSequenceIndices[aVFXSequenceIndex], aRenderInput);
+			return manager->EnqueueTrigger(myVFXSequenceIndices[aVFXSequenceIndex], aRenderInput);
 		}
 
 		void StopVFXSequence(int aVFXSequenceIndex, const VFXRenderInput& aRenderInput) const
@@ -77,7 +306,9 @@ namespace KE
 
 		void AddVFX(const std::string& aVFXName)
 		{
-			myVFXSequenceIndices.push_back(manager->GetVFXSequenceFromName(aVFXName));
+			const int index = manager->GetVFXSequenceFromName(aVFXName);
+			manager->AcquireVFXSequence(index);
+			myVFXSequenceIndices.push_back(index);
 		}
 	};
 
@@ -0,0 +1,132 @@
+#include "stdafx.h"
+#include "VFXMeshAnalysis.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace KE
+{
+	namespace
+	{
+		Vector3f Subtract(const Vector3f& a, const Vector3f& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+		float Dot(const Vector3f& a, const Vector3f& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+		Vector3f Cross(const Vector3f& a, const Vector3f& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+
+		//vertices are split along uv and normal seams, the topology only makes sense once they're welded back together
+		std::vector<uint32_t> WeldPositions(std::span<const Vector3f> somePositions, float aCellSize, std::vector<Vector3f>& outUnique)
+		{
+			struct Key
+			{
+				int64_t x, y, z;
+				uint32_t index;
+			};
+
+			std::vector<Key> keys(somePositions.size());
+			for (uint32_t i = 0; i < somePositions.size(); i++)
+			{
+				const Vector3f& p = somePositions[i];
+				keys[i] = { (int64_t)std::floor(p.x / aCellSize + 0.5f), (int64_t)std::floor(p.y / aCellSize + 0.5f), (int64_t)std::floor(p.z / aCellSize + 0.5f), i };
+			}
+			std::ranges::sort(keys, [](const Key& a, const Key& b) { return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z); });
+
+			std::vector<uint32_t> welded(somePositions.size());
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				if (i == 0 || std::tie(keys[i].x, keys[i].y, keys[i].z) != std::tie(keys[i - 1].x, keys[i - 1].y, keys[i - 1].z))
+				{
+					outUnique.push_back(somePositions[keys[i].index]);
+				}
+				welded[keys[i].index] = (uint32_t)outUnique.size() - 1;
+			}
+			return welded;
+		}
+	}
+
+	VFXMeshShape ClassifyVFXMesh(std::span<const Vector3f> somePositions, std::span<const uint32_t> someIndices)
+	{
+		const size_t triangleCount = someIndices.size() / 3;
+		if (triangleCount == 0 || somePositions.empty()) { return VFXMeshShape::Open; }
+
+		Vector3f minimum = somePositions[0];
+		Vector3f maximum = somePositions[0];
+		for (const Vector3f& p : somePositions)
+		{
+			minimum = { std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+			maximum = { std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+		}
+		const Vector3f extents = Subtract(maximum, minimum);
+		const float radius = std::max(std::sqrt(Dot(extents, extents)) * 0.5f, 1e-6f);
+		const float epsilon = radius * VFX_MESH_ANALYSIS_EPSILON;
+
+		std::vector<Vector3f> unique;
+		const std::vector<uint32_t> welded = WeldPositions(somePositions, epsilon, unique);
+
+		//every edge of a closed mesh is shared by exactly two triangles
+		std::vector<uint64_t> edges;
+		edges.reserve(triangleCount * 3);
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				const uint32_t a = welded[someIndices[t * 3 + e]];
+				const uint32_t b = welded[someIndices[t * 3 + (e + 1) % 3]];
+				if (a == b) { continue; }
+
+				edges.push_back((uint64_t)std::min(a, b) << 32 | std::max(a, b));
+			}
+		}
+		std::ranges::sort(edges);
+
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t run = i;
+			while (run < edges.size() && edges[run] == edges[i]) { run++; }
+
+			if (run - i == 1) { return VFXMeshShape::Open; }
+			i = run;
+		}
+
+		//flat meshes that are closed are double sided cards, they draw like open ones
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			const Vector3f& a = unique[welded[someIndices[t * 3]]];
+			const Vector3f& b = unique[welded[someIndices[t * 3 + 1]]];
+			const Vector3f& c = unique[welded[someIndices[t * 3 + 2]]];
+
+			Vector3f normal = Cross(Subtract(b, a), Subtract(c, a));
+			const float length = std::sqrt(Dot(normal, normal));
+			if (length <= 1e-12f) { continue; }
+			normal = { normal.x / length, normal.y / length, normal.z / length };
+
+			//the first real triangle decides, the mesh is flat if everything lies in its plane
+			const bool isFlat = std::ranges::all_of(unique, [&](const Vector3f& p) { return std::abs(Dot(normal, Subtract(p, a))) <= epsilon; });
+			return isFlat ? VFXMeshShape::Open : VFXMeshShape::Closed;
+		}
+
+		return VFXMeshShape::Open;
+	}
+
+	VFXMeshShape CombineVFXMeshShapes(VFXMeshShape aShape, VFXMeshShape anOtherShape)
+	{
+		return aShape == VFXMeshShape::Open && anOtherShape == VFXMeshShape::Open ? VFXMeshShape::Open : VFXMeshShape::Closed;
+	}
+
+	VFXMeshDrawMode ResolveVFXMeshDrawMode(VFXMeshShape aShape, VFXMeshDrawMode aDrawMode)
+	{
+		if (aDrawMode != VFXMeshDrawMode::Auto) { return aDrawMode; }
+
+		//open meshes have nothing behind their front faces to sort against, closed ones need their back faces drawn first
+		return aShape == VFXMeshShape::Open ? VFXMeshDrawMode::SinglePass : VFXMeshDrawMode::TwoPass;
+	}
+
+	VFXMeshPasses GetVFXMeshPasses(VFXMeshShape aShape, VFXMeshDrawMode aDrawMode)
+	{
+		VFXMeshPasses passes;
+		if (ResolveVFXMeshDrawMode(aShape, aDrawMode) == VFXMeshDrawMode::SinglePass)
+		{
+			passes.passes = { VFXMeshPass::BothFaces, VFXMeshPass::BothFaces };
+			passes.count = 1;
+		}
+		return passes;
+	}
+}
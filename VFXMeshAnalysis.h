@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "Engine/Source/Math/KittyMath.h"
+
+namespace KE
+{
+	constexpr float VFX_MESH_ANALYSIS_EPSILON = 1e-4f; //relative to the mesh's bounding radius
+
+	//convex and concave meshes aren't told apart. both need their back faces drawn before their front faces and
+	//neither pass is sorted within itself, so knowing a mesh is convex wouldn't change how it's drawn
+	enum class VFXMeshShape
+	{
+		Open, //has boundary edges or is flat, planes, ribbons and the like
+		Closed,
+
+		Count
+	};
+
+	static const char* VFXMeshShapeNames[(int)VFXMeshShape::Count] =
+	{
+		"Open",
+		"Closed",
+	};
+
+	enum class VFXMeshDrawMode
+	{
+		Auto, //picked from the mesh's shape
+		SinglePass, //both faces in one draw without culling
+		TwoPass, //back faces first, then front faces, for transparency that can see through the mesh
+
+		Count
+	};
+
+	static const char* VFXMeshDrawModeNames[(int)VFXMeshDrawMode::Count] =
+	{
+		"Auto",
+		"Single Pass",
+		"Two Pass",
+	};
+
+	enum class VFXMeshPass
+	{
+		BackFaces,
+		FrontFaces,
+		BothFaces,
+	};
+
+	struct VFXMeshPasses
+	{
+		std::array<VFXMeshPass, 2> passes = { VFXMeshPass::BackFaces, VFXMeshPass::FrontFaces };
+		int count = 2;
+	};
+
+	VFXMeshShape ClassifyVFXMesh(std::span<const Vector3f> somePositions, std::span<const uint32_t> someIndices);
+
+	//several parts only stay open if every part is open
+	VFXMeshShape CombineVFXMeshShapes(VFXMeshShape aShape, VFXMeshShape anOtherShape);
+
+	VFXMeshDrawMode ResolveVFXMeshDrawMode(VFXMeshShape aShape, VFXMeshDrawMode aDrawMode);
+	VFXMeshPasses GetVFXMeshPasses(VFXMeshShape aShape, VFXMeshDrawMode aDrawMode);
+}
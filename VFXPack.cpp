@@ -0,0 +1,325 @@
+#include "stdafx.h"
+#include "VFXPack.h"
+
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	namespace
+	{
+		bool CookPackSequence(const std::filesystem::path& aFilePath, std::string& outData, VFXCurveReductionReport& outReport, float aTolerance)
+		{
+			std::ifstream file(aFilePath);
+			nlohmann::json sequence = file.is_open() ? nlohmann::json::parse(file, nullptr, false) : nlohmann::json(nlohmann::json::value_t::discarded);
+			if (sequence.is_discarded())
+			{
+				KE_ERROR("Failed to read VFX sequence %s for packing", aFilePath.string().c_str());
+				return false;
+			}
+
+			outReport = ReduceVFXSequenceCurves(sequence, aTolerance);
+			outData = sequence.dump();
+			return true;
+		}
+
+		std::vector<std::filesystem::path> GetLooseSequences(const std::string& aDirectory)
+		{
+			std::vector<std::filesystem::path> files;
+			std::error_code error;
+			for (const auto& entry : std::filesystem::directory_iterator(aDirectory, error))
+			{
+				if (entry.path().extension() == ".kittyVFX") { files.push_back(entry.path()); }
+			}
+			std::ranges::sort(files);
+			return files;
+		}
+	}
+
+	uint64_t HashVFXPackName(std::string_view aName)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (const char c : aName)
+		{
+			hash = (hash ^ (uint8_t)c) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	VFXPack::~VFXPack()
+	{
+		Close();
+	}
+
+	bool VFXPack::Open(const std::string& aFilePath)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(aFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE) { return false; }
+		myFileHandle = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+		mySize = (size_t)size.QuadPart;
+
+		myMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!myMappingHandle)
+		{
+			Close();
+			return false;
+		}
+
+		myData = static_cast<const char*>(MapViewOfFile(myMappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+		const int file = open(aFilePath.c_str(), O_RDONLY);
+		if (file < 0) { return false; }
+
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			close(file);
+			return false;
+		}
+		mySize = (size_t)status.st_size;
+
+		//the mapping keeps the file alive on its own
+		void* view = mmap(nullptr, mySize, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		myData = view != MAP_FAILED ? static_cast<const char*>(view) : nullptr;
+#endif
+
+		if (!myData || !Validate())
+		{
+			KE_ERROR("Failed to open VFX pack %s", aFilePath.c_str());
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void VFXPack::Close()
+	{
+#ifdef _WIN32
+		if (myData) { UnmapViewOfFile(myData); }
+		if (myMappingHandle) { CloseHandle(myMappingHandle); }
+		if (myFileHandle) { CloseHandle(myFileHandle); }
+#else
+		if (myData) { munmap(const_cast<char*>(myData), mySize); }
+#endif
+
+		myFileHandle = nullptr;
+		myMappingHandle = nullptr;
+		myData = nullptr;
+		mySize = 0;
+		myEntries = nullptr;
+		myNames = nullptr;
+		myEntryCount = 0;
+	}
+
+	bool VFXPack::Validate()
+	{
+		if (mySize < sizeof(VFXPackHeader)) { return false; }
+
+		VFXPackHeader header;
+		std::memcpy(&header, myData, sizeof(header));
+		if (header.magic != VFX_PACK_MAGIC || header.version != VFX_PACK_VERSION) { return false; }
+
+		const size_t tocEnd = sizeof(VFXPackHeader) + (size_t)header.entryCount * sizeof(VFXPackEntry);
+		const size_t namesEnd = tocEnd + header.nameTableSize;
+		if (namesEnd > mySize) { return false; }
+
+		//the mapping is page aligned and the header keeps the table of contents 8 byte aligned
+		myEntries = reinterpret_cast<const VFXPackEntry*>(myData + sizeof(VFXPackHeader));
+		myNames = myData + tocEnd;
+		myEntryCount = header.entryCount;
+
+		for (uint32_t i = 0; i < myEntryCount; i++)
+		{
+			const VFXPackEntry& entry = myEntries[i];
+			if (entry.dataOffset < namesEnd || entry.dataOffset + entry.dataSize > mySize) { return false; }
+			if ((size_t)entry.nameOffset + entry.nameSize > header.nameTableSize) { return false; }
+			if (i > 0 && myEntries[i - 1].nameHash > entry.nameHash) { return false; }
+		}
+		return true;
+	}
+
+	std::string_view VFXPack::Find(std::string_view aSequenceName) const
+	{
+		if (!myData) { return {}; }
+
+		const uint64_t hash = HashVFXPackName(aSequenceName);
+		const VFXPackEntry* end = myEntries + myEntryCount;
+		const VFXPackEntry* entry = std::lower_bound(myEntries, end, hash, [](const VFXPackEntry& anEntry, uint64_t aHash) { return anEntry.nameHash < aHash; });
+
+		for (; entry != end && entry->nameHash == hash; entry++)
+		{
+			const uint32_t index = (uint32_t)(entry - myEntries);
+			if (GetName(index) == aSequenceName) { return GetData(index); }
+		}
+		return {};
+	}
+
+	std::string_view VFXPack::GetName(uint32_t anEntryIndex) const
+	{
+		const VFXPackEntry& entry = myEntries[anEntryIndex];
+		return { myNames + entry.nameOffset, entry.nameSize };
+	}
+
+	std::string_view VFXPack::GetData(uint32_t anEntryIndex) const
+	{
+		const VFXPackEntry& entry = myEntries[anEntryIndex];
+		return { myData + entry.dataOffset, (size_t)entry.dataSize };
+	}
+
+	bool BuildVFXPack(const std::string& aSourceDirectory, const std::string& aPackPath, VFXPackBuildReport& outReport, float aTolerance)
+	{
+		outReport = {};
+
+		struct CookedSequence
+		{
+			std::string name;
+			std::string data;
+		};
+		std::vector<CookedSequence> sequences;
+
+		for (const std::filesystem::path& path : GetLooseSequences(aSourceDirectory))
+		{
+			CookedSequence& sequence = sequences.emplace_back();
+			sequence.name = path.stem().string();
+
+			VFXCurveReductionReport curves;
+			if (!CookPackSequence(path, sequence.data, curves, aTolerance)) { return false; }
+
+			outReport.curves.curves += curves.curves;
+			outReport.curves.pointsBefore += curves.pointsBefore;
+			outReport.curves.pointsRemoved += curves.pointsRemoved;
+			outReport.looseBytes += std::filesystem::file_size(path);
+		}
+
+		std::ranges::sort(sequences, [](const CookedSequence& a, const CookedSequence& b) { return HashVFXPackName(a.name) < HashVFXPackName(b.name); });
+
+		VFXPackHeader header;
+		header.entryCount = (uint32_t)sequences.size();
+
+		std::string names;
+		std::vector<VFXPackEntry> entries(sequences.size());
+		for (int i = 0; i < sequences.size(); i++)
+		{
+			entries[i].nameHash = HashVFXPackName(sequences[i].name);
+			entries[i].nameOffset = (uint32_t)names.size();
+			entries[i].nameSize = (uint32_t)sequences[i].name.size();
+			names += sequences[i].name;
+		}
+		header.nameTableSize = (uint32_t)names.size();
+
+		uint64_t offset = sizeof(VFXPackHeader) + entries.size() * sizeof(VFXPackEntry) + names.size();
+		for (int i = 0; i < sequences.size(); i++)
+		{
+			entries[i].dataOffset = offset;
+			entries[i].dataSize = sequences[i].data.size();
+			offset += entries[i].dataSize;
+		}
+
+		//written next to the pack and renamed over it, so a failed build never leaves half a pack behind. a running game
+		//keeps its mapping of the old pack on posix, on windows the mapped pack can't be replaced and the build fails
+		const std::string tempPath = aPackPath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				KE_ERROR("Failed to write VFX pack %s", aPackPath.c_str());
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(VFXPackEntry));
+			file.write(names.data(), names.size());
+			for (const CookedSequence& sequence : sequences)
+			{
+				file.write(sequence.data.data(), sequence.data.size());
+			}
+
+			if (!file.good())
+			{
+				KE_ERROR("Failed to write VFX pack %s", aPackPath.c_str());
+				file.close();
+				std::error_code error;
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, aPackPath, error);
+		if (error)
+		{
+			KE_ERROR("Failed to replace VFX pack %s", aPackPath.c_str());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		outReport.sequences = (int)sequences.size();
+		outReport.packBytes = (size_t)offset;
+		return true;
+	}
+
+	int VerifyVFXPack(const std::string& aPackPath, const std::string& aSourceDirectory, float aTolerance)
+	{
+		VFXPack pack;
+		if (!pack.Open(aPackPath)) { return -1; }
+
+		int mismatches = 0;
+		std::vector<std::string> looseNames;
+
+		for (const std::filesystem::path& path : GetLooseSequences(aSourceDirectory))
+		{
+			const std::string name = path.stem().string();
+			looseNames.push_back(name);
+
+			const std::string_view packed = pack.Find(name);
+			if (packed.empty())
+			{
+				KE_ERROR("VFX pack %s is missing sequence %s", aPackPath.c_str(), name.c_str());
+				mismatches++;
+				continue;
+			}
+
+			std::string cooked;
+			VFXCurveReductionReport curves;
+			if (!CookPackSequence(path, cooked, curves, aTolerance) || cooked != packed)
+			{
+				KE_ERROR("VFX pack %s has a stale copy of sequence %s", aPackPath.c_str(), name.c_str());
+				mismatches++;
+			}
+		}
+
+		for (uint32_t i = 0; i < pack.GetEntryCount(); i++)
+		{
+			const std::string_view name = pack.GetName(i);
+			if (std::ranges::find(looseNames, name) == looseNames.end())
+			{
+				KE_ERROR("VFX pack %s contains sequence %.*s which has no loose file", aPackPath.c_str(), (int)name.size(), name.data());
+				mismatches++;
+			}
+		}
+
+		return mismatches;
+	}
+}
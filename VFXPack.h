@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Engine/Source/Graphics/FX/VFXCurveReduction.h"
+
+namespace KE
+{
+	constexpr const char* VFX_PACK_FILE_LOCATION = "Data/InternalAssets/VFXSequences.kittyVFXPack";
+	constexpr uint32_t VFX_PACK_MAGIC = 0x5046564B; //"KVFP"
+	constexpr uint32_t VFX_PACK_VERSION = 1;
+
+	//layout: header, table of contents sorted by name hash, name table, then the cooked sequences back to back
+	struct VFXPackHeader
+	{
+		uint32_t magic = VFX_PACK_MAGIC;
+		uint32_t version = VFX_PACK_VERSION;
+		uint32_t entryCount = 0;
+		uint32_t nameTableSize = 0;
+	};
+
+	struct VFXPackEntry
+	{
+		uint64_t nameHash = 0;
+		uint64_t dataOffset = 0; //from the start of the file
+		uint64_t dataSize = 0;
+		uint32_t nameOffset = 0; //into the name table, names are kept so hash collisions can be told apart
+		uint32_t nameSize = 0;
+	};
+
+	uint64_t HashVFXPackName(std::string_view aName);
+
+	//read only view of a pack file, the sequences are parsed straight out of the mapping
+	class VFXPack
+	{
+	private:
+		void* myFileHandle = nullptr;
+		void* myMappingHandle = nullptr;
+		const char* myData = nullptr;
+		size_t mySize = 0;
+
+		const VFXPackEntry* myEntries = nullptr;
+		const char* myNames = nullptr;
+		uint32_t myEntryCount = 0;
+
+		bool Validate();
+
+	public:
+		VFXPack() = default;
+		~VFXPack();
+
+		VFXPack(const VFXPack&) = delete;
+		VFXPack& operator=(const VFXPack&) = delete;
+
+		bool Open(const std::string& aFilePath);
+		void Close();
+
+		inline bool IsOpen() const { return myData != nullptr; }
+		inline uint32_t GetEntryCount() const { return myEntryCount; }
+
+		//empty if the pack doesn't contain the sequence, the view stays valid until the pack is closed
+		std::string_view Find(std::string_view aSequenceName) const;
+		std::string_view GetName(uint32_t anEntryIndex) const;
+		std::string_view GetData(uint32_t anEntryIndex) const;
+	};
+
+	struct VFXPackBuildReport
+	{
+		int sequences = 0;
+		size_t looseBytes = 0;
+		size_t packBytes = 0;
+		VFXCurveReductionReport curves;
+	};
+
+	//cooks every .kittyVFX in the directory into a pack, sequences are named by their file stem like LoadVFXSequence expects
+	bool BuildVFXPack(const std::string& aSourceDirectory, const std::string& aPackPath, VFXPackBuildReport& outReport, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+
+	//cooks the loose files again and compares them against the pack, returns the number of missing, stale or extra sequences
+	int VerifyVFXPack(const std::string& aPackPath, const std::string& aSourceDirectory, float aTolerance = VFX_CURVE_REDUCTION_TOLERANCE);
+}
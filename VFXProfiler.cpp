@@ -0,0 +1,190 @@
+#include "stdafx.h"
+#include "VFXProfiler.h"
+
+#ifdef KE_VFX_PROFILING
+#include <thread>
+
+#include <External/Include/nlohmann/json.hpp>
+
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	void VFXProfiler::BeginFrame()
+	{
+		std::lock_guard lock(myMutex);
+
+		myCurrentFrame = (myCurrentFrame + 1) % VFX_PROFILER_FRAME_COUNT;
+		myRecordedFrames = std::min(myRecordedFrames + 1, VFX_PROFILER_FRAME_COUNT);
+
+		VFXProfileFrame& frame = myFrames[myCurrentFrame];
+		for (const VFXSequenceCostSample& sample : frame.sequenceCosts)
+		{
+			VFXSequenceCostSample& total = mySequenceTotals[sample.sequenceIndex];
+			total.cpuMicroseconds -= sample.cpuMicroseconds;
+			total.instances -= sample.instances;
+			total.packages -= sample.packages;
+			total.draws -= sample.draws;
+			total.particles -= sample.particles;
+		}
+
+		frame.start = GetTime();
+		frame.events.clear();
+		frame.sequenceCosts.clear();
+		frame.counters.fill(0);
+	}
+
+	int64_t VFXProfiler::GetTime() const
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - myEpoch).count();
+	}
+
+	void VFXProfiler::AddEvent(const char* aName, int64_t aStart, int64_t anEnd)
+	{
+		const uint32_t threadId = (uint32_t)std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+		std::lock_guard lock(myMutex);
+		myFrames[myCurrentFrame].events.push_back({ aName, aStart, anEnd - aStart, threadId });
+	}
+
+	void VFXProfiler::AddCounter(VFXCounter aCounter, int64_t aValue)
+	{
+		std::lock_guard lock(myMutex);
+		myFrames[myCurrentFrame].counters[(int)aCounter] += aValue;
+	}
+
+	void VFXProfiler::SetCounter(VFXCounter aCounter, int64_t aValue)
+	{
+		std::lock_guard lock(myMutex);
+		myFrames[myCurrentFrame].counters[(int)aCounter] = aValue;
+	}
+
+	void VFXProfiler::AddSequenceCost(const VFXSequenceCostSample& aSample)
+	{
+		if (aSample.sequenceIndex < 0) { return; }
+
+		std::lock_guard lock(myMutex);
+
+		if (aSample.sequenceIndex >= mySequenceTotals.size())
+		{
+			mySequenceTotals.resize(aSample.sequenceIndex + 1);
+			for (int i = 0; i < mySequenceTotals.size(); i++) { mySequenceTotals[i].sequenceIndex = i; }
+		}
+
+		VFXSequenceCostSample& frameSample = GetFrameSequenceSample(aSample.sequenceIndex);
+		VFXSequenceCostSample& total = mySequenceTotals[aSample.sequenceIndex];
+		for (VFXSequenceCostSample* target : { &frameSample, &total })
+		{
+			target->cpuMicroseconds += aSample.cpuMicroseconds;
+			target->instances += aSample.instances;
+			target->packages += aSample.packages;
+			target->draws += aSample.draws;
+			target->particles += aSample.particles;
+		}
+	}
+
+	VFXSequenceCostSample& VFXProfiler::GetFrameSequenceSample(int aSequenceIndex)
+	{
+		//only a handful of sequences are live in a frame, a linear search beats a map here
+		auto& samples = myFrames[myCurrentFrame].sequenceCosts;
+		for (VFXSequenceCostSample& sample : samples)
+		{
+			if (sample.sequenceIndex == aSequenceIndex) { return sample; }
+		}
+
+		VFXSequenceCostSample& sample = samples.emplace_back();
+		sample.sequenceIndex = aSequenceIndex;
+		return sample;
+	}
+
+	std::vector<VFXSequenceCost> VFXProfiler::GetSequenceCosts() const
+	{
+		std::lock_guard lock(myMutex);
+
+		std::vector<VFXSequenceCost> costs;
+		if (myRecordedFrames == 0) { return costs; }
+
+		const float frameCount = (float)myRecordedFrames;
+		for (const VFXSequenceCostSample& total : mySequenceTotals)
+		{
+			if (total.instances == 0 && total.cpuMicroseconds == 0) { continue; }
+
+			VFXSequenceCost& cost = costs.emplace_back();
+			cost.sequenceIndex = total.sequenceIndex;
+			cost.cpuMicroseconds = (float)total.cpuMicroseconds / frameCount;
+			cost.instances = (float)total.instances / frameCount;
+			cost.packages = (float)total.packages / frameCount;
+			cost.draws = (float)total.draws / frameCount;
+			cost.particles = (float)total.particles / frameCount;
+		}
+
+		return costs;
+	}
+
+	int64_t VFXProfiler::GetCounterAverage(VFXCounter aCounter) const
+	{
+		std::lock_guard lock(myMutex);
+		if (myRecordedFrames == 0) { return 0; }
+
+		int64_t total = 0;
+		for (int i = 0; i < myRecordedFrames; i++)
+		{
+			total += myFrames[(myCurrentFrame - i + VFX_PROFILER_FRAME_COUNT) % VFX_PROFILER_FRAME_COUNT].counters[(int)aCounter];
+		}
+		return total / myRecordedFrames;
+	}
+
+	bool VFXProfiler::DumpChromeTrace(const std::string& aFilePath) const
+	{
+		nlohmann::json trace;
+		trace["traceEvents"] = nlohmann::json::array();
+		auto& traceEvents = trace["traceEvents"];
+
+		{
+			std::lock_guard lock(myMutex);
+
+			//oldest frame first
+			for (int i = myRecordedFrames - 1; i >= 0; i--)
+			{
+				const VFXProfileFrame& frame = myFrames[(myCurrentFrame - i + VFX_PROFILER_FRAME_COUNT) % VFX_PROFILER_FRAME_COUNT];
+
+				for (const VFXProfileEvent& event : frame.events)
+				{
+					traceEvents.push_back({
+						{ "name", event.name },
+						{ "cat", "VFX" },
+						{ "ph", "X" },
+						{ "ts", event.start },
+						{ "dur", event.duration },
+						{ "pid", 0 },
+						{ "tid", event.threadId }
+					});
+				}
+
+				for (int counter = 0; counter < (int)VFXCounter::Count; counter++)
+				{
+					traceEvents.push_back({
+						{ "name", VFXCounterNames[counter] },
+						{ "cat", "VFX" },
+						{ "ph", "C" },
+						{ "ts", frame.start },
+						{ "pid", 0 },
+						{ "args", { { "value", frame.counters[counter] } } }
+					});
+				}
+			}
+		}
+
+		std::ofstream file(aFilePath);
+		if (!file.is_open())
+		{
+			KE_ERROR("Failed to write VFX trace %s", aFilePath.c_str());
+			return false;
+		}
+
+		file << trace.dump();
+		return true;
+	}
+}
+
+#endif
@@ -0,0 +1,160 @@
+#pragma once
+
+//the profiler only exists in builds with the editor, shipping builds compile every scope and counter away
+#ifndef KITTYENGINE_NO_EDITOR
+#define KE_VFX_PROFILING
+#endif
+
+#ifdef KE_VFX_PROFILING
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#endif
+
+namespace KE
+{
+	enum class VFXCounter
+	{
+		LivePlayers,
+		SharedPlacements,
+		RenderPackages,
+		MeshDraws,
+		SpriteDraws,
+		StateChanges,
+		Particles,
+
+		Count
+	};
+
+	static const char* VFXCounterNames[(int)VFXCounter::Count] =
+	{
+		"Live Players",
+		"Shared Placements",
+		"Render Packages",
+		"Mesh Draws",
+		"Sprite Draws",
+		"State Changes",
+		"Particles",
+	};
+
+	struct VFXSequenceCost
+	{
+		int sequenceIndex = -1;
+
+		//per frame averages over the profiler window
+		float cpuMicroseconds = 0.0f;
+		float instances = 0.0f;
+		float packages = 0.0f;
+		float draws = 0.0f; //mesh passes plus emitter batches, before sprite batches get merged
+		float particles = 0.0f;
+
+		float GetCPUPerInstance() const { return instances > 0.0f ? cpuMicroseconds / instances : 0.0f; }
+	};
+
+#ifdef KE_VFX_PROFILING
+	constexpr int VFX_PROFILER_FRAME_COUNT = 300;
+
+	struct VFXSequenceCostSample
+	{
+		int sequenceIndex = -1;
+		int64_t cpuMicroseconds = 0;
+		int64_t instances = 0;
+		int64_t packages = 0;
+		int64_t draws = 0;
+		int64_t particles = 0;
+	};
+
+	struct VFXProfileEvent
+	{
+		const char* name;
+		int64_t start; //microseconds since the profiler was created
+		int64_t duration;
+		uint32_t threadId;
+	};
+
+	struct VFXProfileFrame
+	{
+		int64_t start = 0;
+		std::vector<VFXProfileEvent> events;
+		std::array<int64_t, (size_t)VFXCounter::Count> counters{};
+		std::vector<VFXSequenceCostSample> sequenceCosts;
+	};
+
+	class VFXProfiler
+	{
+	private:
+		std::array<VFXProfileFrame, VFX_PROFILER_FRAME_COUNT> myFrames;
+		int myCurrentFrame = 0;
+		int myRecordedFrames = 0;
+		std::chrono::steady_clock::time_point myEpoch = std::chrono::steady_clock::now();
+
+		//window totals per sequence index, samples leaving the window get subtracted again
+		std::vector<VFXSequenceCostSample> mySequenceTotals;
+
+		//render can run on its own thread when pipelined
+		mutable std::mutex myMutex;
+
+		VFXSequenceCostSample& GetFrameSequenceSample(int aSequenceIndex);
+
+	public:
+		void BeginFrame();
+
+		int64_t GetTime() const;
+		void AddEvent(const char* aName, int64_t aStart, int64_t anEnd);
+		void AddCounter(VFXCounter aCounter, int64_t aValue);
+		void SetCounter(VFXCounter aCounter, int64_t aValue);
+		void AddSequenceCost(const VFXSequenceCostSample& aSample);
+
+		std::vector<VFXSequenceCost> GetSequenceCosts() const;
+
+		//averages over the recorded window
+		int64_t GetCounterAverage(VFXCounter aCounter) const;
+		bool DumpChromeTrace(const std::string& aFilePath) const;
+	};
+
+	class VFXProfileScope
+	{
+	private:
+		VFXProfiler& myProfiler;
+		const char* myName;
+		int64_t myStart;
+
+	public:
+		VFXProfileScope(VFXProfiler& aProfiler, const char* aName) : myProfiler(aProfiler), myName(aName), myStart(aProfiler.GetTime()) {}
+		~VFXProfileScope() { myProfiler.AddEvent(myName, myStart, myProfiler.GetTime()); }
+	};
+
+	class VFXSequenceCostScope
+	{
+	private:
+		VFXProfiler& myProfiler;
+		VFXSequenceCostSample mySample;
+		int64_t myStart;
+
+	public:
+		VFXSequenceCostScope(VFXProfiler& aProfiler, int aSequenceIndex) : myProfiler(aProfiler), myStart(aProfiler.GetTime()) { mySample.sequenceIndex = aSequenceIndex; }
+		~VFXSequenceCostScope()
+		{
+			mySample.cpuMicroseconds = myProfiler.GetTime() - myStart;
+			myProfiler.AddSequenceCost(mySample);
+		}
+
+		inline VFXSequenceCostSample& GetSample() { return mySample; }
+	};
+#endif
+}
+
+#ifdef KE_VFX_PROFILING
+#define KE_VFX_PROFILE_CONCAT_INNER(a, b) a##b
+#define KE_VFX_PROFILE_CONCAT(a, b) KE_VFX_PROFILE_CONCAT_INNER(a, b)
+#define KE_VFX_PROFILE_SCOPE(aProfiler, aName) KE::VFXProfileScope KE_VFX_PROFILE_CONCAT(vfxProfileScope, __LINE__)(aProfiler, aName)
+#define KE_VFX_PROFILE_COUNTER_ADD(aProfiler, aCounter, aValue) (aProfiler).AddCounter(KE::VFXCounter::aCounter, (int64_t)(aValue))
+#define KE_VFX_PROFILE_COUNTER_SET(aProfiler, aCounter, aValue) (aProfiler).SetCounter(KE::VFXCounter::aCounter, (int64_t)(aValue))
+#else
+#define KE_VFX_PROFILE_SCOPE(aProfiler, aName) ((void)0)
+#define KE_VFX_PROFILE_COUNTER_ADD(aProfiler, aCounter, aValue) ((void)0)
+#define KE_VFX_PROFILE_COUNTER_SET(aProfiler, aCounter, aValue) ((void)0)
+#endif
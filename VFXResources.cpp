@@ -6,6 +6,23 @@
 
 namespace KE
 {
+	float InterpolateVFXCurve(VFXCurveProfiles aProfile, const Vector2f& aLower, const Vector2f& anUpper, float aTime)
+	{
+		const float timeFraction = (aTime - aLower.x) / (anUpper.x - aLower.x);
+
+		switch (aProfile)
+		{
+		case VFXCurveProfiles::Linear:
+			return aLower.y + (anUpper.y - aLower.y) * timeFraction;
+		case VFXCurveProfiles::Smooth:
+			return aLower.y + (anUpper.y - aLower.y) * Smoothstep(timeFraction);
+		case VFXCurveProfiles::Discrete:
+			return aLower.y;
+		default:
+			return 0.0f;
+		}
+	}
+
 	float VFXCurveDataSet::GetEvaluatedValue(int aFrameIndex, int aFirstFrameIndex, int aLastFrameIndex) const
 	{
 		const float leastTime = myData.front().x;
@@ -15,66 +32,77 @@ namespace KE
 		const float frameProgressFraction = (float)(aFrameIndex - aFirstFrameIndex) / (float)(aLastFrameIndex - aFirstFrameIndex);
 		const float time = leastTime + (mostTime - leastTime) * frameProgressFraction;
 
-		//find the two closest points
-		int lowerClosestPoint = -1;
-		int upperClosestPoint = -1;
+		//points are kept sorted by time, the first one past the time is the upper point
+		const auto upper = std::upper_bound(myData.begin(), myData.end(), time, [](float aTime, const Vector2f& aPoint) { return aTime < aPoint.x; });
 
-		for (int i = 0; i < myData.size(); ++i)
+		if (upper == myData.begin())
 		{
-			if (myData[i].x <= time)
-			{
-				lowerClosestPoint = i;
-			}
-			else
-			{
-				upperClosestPoint = i;
-				break;
-			}
+			return upper->y;
 		}
-
-		if (lowerClosestPoint == -1)
+		else if (upper == myData.end())
 		{
-			return myData[upperClosestPoint].y;
+			return myData.back().y;
 		}
-		else if (upperClosestPoint == -1)
+		else
 		{
-			return myData[lowerClosestPoint].y;
+			const float value = InterpolateVFXCurve(myCurveProfile, *(upper - 1), *upper, time);
+			return myMinValue + (myMaxValue - myMinValue) * value;
 		}
-		else
+	}
+
+
+	bool VFXCurveDataSet::IsConstantBetween(int aFrameIndex, int anOtherFrameIndex, int aFirstFrameIndex, int aLastFrameIndex) const
+	{
+		if (aFrameIndex == anOtherFrameIndex) { return true; }
+		if (myCurveProfile == VFXCurveProfiles::None) { return true; }
+
+		const float leastTime = myData.front().x;
+		const float mostTime = myData.back().x;
+		const auto getUpper = [&](int aFrame)
 		{
-			const float lowerTime = myData[lowerClosestPoint].x;
-			const float upperTime = myData[upperClosestPoint].x;
-			const float lowerValue = myData[lowerClosestPoint].y;
-			const float upperValue = myData[upperClosestPoint].y;
-			const float timeFraction = (time - lowerTime) / (upperTime - lowerTime);
-			float value = 0.0f;
-
-			switch (myCurveProfile)
-			{
-			case VFXCurveProfiles::Linear:
-			{
-				value = lowerValue + (upperValue - lowerValue) * timeFraction;
-				break;
-			}
-			case VFXCurveProfiles::Smooth:
-			{
-				const float smoothStep = Smoothstep(timeFraction);
-				value = lowerValue + (upperValue - lowerValue) * smoothStep;
-				break;
-			}
-			case VFXCurveProfiles::Discrete:
-			{
-				value = lowerValue;
-				break;
-			}
-			default:
-				break;
-			}
+			const float frameProgressFraction = (float)(aFrame - aFirstFrameIndex) / (float)(aLastFrameIndex - aFirstFrameIndex);
+			const float time = leastTime + (mostTime - leastTime) * frameProgressFraction;
+			return std::upper_bound(myData.begin(), myData.end(), time, [](float aTime, const Vector2f& aPoint) { return aTime < aPoint.x; });
+		};
 
-			return myMinValue + (myMaxValue - myMinValue) * value;
+		auto first = getUpper(std::min(aFrameIndex, anOtherFrameIndex));
+		auto last = getUpper(std::max(aFrameIndex, anOtherFrameIndex));
+
+		//before the first and past the last point the value isn't remapped, a range reaching across that boundary isn't constant
+		const auto getRegion = [this](auto anUpper) { return anUpper == myData.begin() ? 0 : anUpper == myData.end() ? 2 : 1; };
+		if (getRegion(first) != getRegion(last)) { return false; }
+		if (getRegion(first) != 1) { return true; }
+
+		//every point from the lower point of the first segment to the upper point of the last one has to share its value,
+		//discrete curves hold the lower point's value so their last upper point doesn't matter
+		const auto end = myCurveProfile == VFXCurveProfiles::Discrete ? last : last + 1;
+		const float value = (first - 1)->y;
+		return std::all_of(first, end, [value](const Vector2f& aPoint) { return aPoint.y == value; });
+	}
+
+	bool VFXTimeStamp::IsConstantBetween(int aFrame, int anOtherFrame) const
+	{
+		for (const VFXCurveDataSet& curve : myCurveDataSets)
+		{
+			if (curve.IsValid() && !curve.IsConstantBetween(aFrame, anOtherFrame, myStartpoint, myEndpoint)) { return false; }
 		}
+		for (const VFXCurveDataSet& curve : myCustomCurveDataSets)
+		{
+			if (curve.IsValid() && !curve.IsConstantBetween(aFrame, anOtherFrame, myStartpoint, myEndpoint)) { return false; }
+		}
+		return true;
+	}
+
+	bool IsVFXParticleAlive(decltype(SpriteBatch::myInstances)::value_type& anInstance)
+	{
+		const Vector3f scale = anInstance.myTransform.GetScale();
+		return scale.x != 0.0f || scale.y != 0.0f;
 	}
 
+	int GetVFXLiveParticleCount(SpriteBatch& aBatch)
+	{
+		return (int)std::ranges::count_if(aBatch.myInstances, IsVFXParticleAlive);
+	}
 
 	VFXRenderInput::VFXRenderInput(Transform& aTransform, bool aIsLooping, bool aIsStationary)
 	{
@@ -101,4 +129,118 @@ namespace KE
 		auto& newEmitter = myParticleEmitters.emplace_back();
 		myManager->InitializeParticleEmitter(newEmitter.myEmitter);
 	}
+
+	bool VFXSequence::AddCustomAttribute(const std::string& aName, float aDefaultValue)
+	{
+		if (myCustomAttributes.size() >= VFX_MAX_CUSTOM_ATTRIBUTES || aName.empty() || GetCustomAttributeIndex(aName) >= 0) { return false; }
+
+		myCustomAttributes.push_back({ aName, aDefaultValue });
+		return true;
+	}
+
+	void VFXSequence::RemoveCustomAttribute(int anIndex)
+	{
+		if (anIndex < 0 || anIndex >= (int)myCustomAttributes.size()) { return; }
+		myCustomAttributes.erase(myCustomAttributes.begin() + anIndex);
+
+		//the attributes after it move down a slot, their curves follow
+		for (VFXTimeStamp& timestamp : myTimestamps)
+		{
+			auto& curves = timestamp.myCustomCurveDataSets;
+			std::move(curves.begin() + anIndex + 1, curves.end(), curves.begin() + anIndex);
+			curves.back() = {};
+
+			for (int i = anIndex; i < (int)curves.size(); i++)
+			{
+				if (curves[i].IsValid()) { curves[i].myCustomIndex = i; }
+			}
+		}
+	}
+
+	int VFXSequence::GetCustomAttributeIndex(const std::string& aName) const
+	{
+		const auto it = std::ranges::find(myCustomAttributes, aName, &VFXCustomAttribute::myName);
+		return it != myCustomAttributes.end() ? (int)(it - myCustomAttributes.begin()) : -1;
+	}
+
+	const VFXLODLevel* VFXSequence::GetLODLevel(int aLODLevel) const
+	{
+		if (aLODLevel <= 0 || aLODLevel > (int)myLODLevels.size()) { return nullptr; }
+		return &myLODLevels[aLODLevel - 1];
+	}
+
+	int VFXSequence::SelectLODLevel(float aDistance, int aCurrentLODLevel) const
+	{
+		int level = std::clamp(aCurrentLODLevel, 0, (int)myLODLevels.size());
+
+		//only move past a threshold once we're clearly on the other side of it, so players sitting on the edge don't flicker
+		while (level < (int)myLODLevels.size() && aDistance > myLODLevels[level].myDistance * (1.0f + VFX_LOD_HYSTERESIS))
+		{
+			level++;
+		}
+		while (level > 0 && aDistance < myLODLevels[level - 1].myDistance * (1.0f - VFX_LOD_HYSTERESIS))
+		{
+			level--;
+		}
+
+		return level;
+	}
+
+	void VFXSequence::SortLODLevels()
+	{
+		std::vector<int> order(myLODLevels.size());
+		for (int i = 0; i < order.size(); i++) { order[i] = i; }
+		std::ranges::stable_sort(order, [this](int a, int b) { return myLODLevels[a].myDistance < myLODLevels[b].myDistance; });
+
+		std::vector<VFXLODLevel> sorted;
+		sorted.reserve(myLODLevels.size());
+		for (const int index : order) { sorted.push_back(myLODLevels[index]); }
+		myLODLevels = std::move(sorted);
+
+		//the hidden bits move with their levels
+		for (VFXTimeStamp& timestamp : myTimestamps)
+		{
+			uint32_t mask = 0;
+			for (int i = 0; i < order.size(); i++)
+			{
+				if (timestamp.myLODHiddenMask & 1u << order[i]) { mask |= 1u << i; }
+			}
+			timestamp.myLODHiddenMask = mask;
+		}
+	}
+
+	void VFXSequence::RemoveLODLevel(int anIndex)
+	{
+		if (anIndex < 0 || anIndex >= (int)myLODLevels.size()) { return; }
+		myLODLevels.erase(myLODLevels.begin() + anIndex);
+
+		//the levels after it move down a slot, their hidden bits follow
+		for (VFXTimeStamp& timestamp : myTimestamps)
+		{
+			const uint64_t mask = timestamp.myLODHiddenMask;
+			const uint64_t below = mask & ((1ull << anIndex) - 1);
+			timestamp.myLODHiddenMask = (uint32_t)(below | mask >> (anIndex + 1) << anIndex);
+		}
+	}
+
+	bool VFXSequence::IsTimestampHidden(int aLODLevel, int aTimestampIndex) const
+	{
+		if (aLODLevel <= 0 || aLODLevel > VFX_MAX_LOD_LEVELS || aTimestampIndex < 0 || aTimestampIndex >= (int)myTimestamps.size()) { return false; }
+		return myTimestamps[aTimestampIndex].myLODHiddenMask & 1u << (aLODLevel - 1);
+	}
+
+	void VFXSequence::SetTimestampHidden(int aLODLevel, int aTimestampIndex, bool aHidden)
+	{
+		if (aLODLevel <= 0 || aLODLevel > VFX_MAX_LOD_LEVELS || aTimestampIndex < 0 || aTimestampIndex >= (int)myTimestamps.size()) { return; }
+
+		uint32_t& mask = myTimestamps[aTimestampIndex].myLODHiddenMask;
+		mask = aHidden ? mask | 1u << (aLODLevel - 1) : mask & ~(1u << (aLODLevel - 1));
+	}
+
+	size_t VFXMemoryUsage::GetTotal() const
+	{
+		size_t total = 0;
+		for (const size_t bytes : myBytes) { total += bytes; }
+		return total;
+	}
 }
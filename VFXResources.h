@@ -1,12 +1,32 @@
 #pragma once
+#include "Engine/Source/Graphics/Camera.h"
 #include "Engine/Source/Graphics/ModelData.h"
 #include "Engine/Source/Graphics/Particle/ParticleEmitter.h"
+#include "Engine/Source/Graphics/FX/VFXMeshAnalysis.h"
+#include "Engine/Source/Graphics/FX/VFXBloom.h"
+
+#include <filesystem>
+#include <optional>
 
 namespace KE
 {
 	class CBuffer;
+
+	using VFXInstanceHandle = int;
+	constexpr VFXInstanceHandle VFX_INVALID_HANDLE = -1;
+
 	constexpr int VFX_SEQUENCE_FRAME_RATE = 120;
+	constexpr int VFX_MAX_SHARED_PHASE_VARIANTS = 8;
+	constexpr int VFX_DEFAULT_EMITTER_LOOKAHEAD = VFX_SEQUENCE_FRAME_RATE / 10; //frames before its window an emitter copy is acquired
+	constexpr float VFX_PREWARM_STEP = 1.0f / 30.0f; //seconds per catch-up step when seeking emitters
+	constexpr float VFX_LOD_HYSTERESIS = 0.1f; //fraction of a LOD distance a player has to cross past it before switching
 	constexpr const char* VFX_SEQUENCE_FILE_LOCATION = "Data/InternalAssets/VFXSequences/";
+	constexpr float VFX_HOT_RELOAD_INTERVAL = 0.5f; //seconds between polling the loaded files for changes
+	constexpr size_t VFX_DEFAULT_RESIDENCY_BUDGET = 64 * 1024 * 1024; //bytes of sequence data kept loaded before unused sequences are evicted
+	constexpr int VFX_RESIDENCY_GRACE_FRAMES = 2; //update frames a sequence stays loaded after its last use so short gaps don't reload it
+	constexpr int VFX_MAX_CUSTOM_ATTRIBUTES = 8; //packed four to a float4 at the end of VFXBufferData
+	constexpr int VFX_MAX_LOD_LEVELS = 32; //one hidden bit per level on every timestamp
+	constexpr int VFX_PARTICLE_EMITTER_CAPACITY = 1024; //particles per emitter template
 
 	class ParticleEmitter;
 	class SpriteManager;
@@ -22,6 +42,9 @@ namespace KE
 
 		Vector2f uvScale;
 		Vector4f bloomAttributes;
+
+		//the sequence's custom attributes in declaration order, unused slots are zero
+		Vector4f customAttributes[VFX_MAX_CUSTOM_ATTRIBUTES / 4];
 	};
 
 	enum class VFXType : int
@@ -131,6 +154,10 @@ namespace KE
 		"Smooth",
 	};
 
+	//value between two neighbouring curve points, before the curve's min and max are applied
+	float InterpolateVFXCurve(VFXCurveProfiles aProfile, const Vector2f& aLower, const Vector2f& anUpper, float aTime);
+
+	//prefer a sequence's custom attributes where curves are enough, those ride along in the per instance buffer instead of a map and bind per draw
 	struct VFXCustomBufferInput
 	{
 		CBuffer* constantBuffer = nullptr;
@@ -143,6 +170,7 @@ namespace KE
 	struct VFXCurveDataSet
 	{
 		VFXAttributeTypes myType = VFXAttributeTypes::Count;
+		int myCustomIndex = -1; //set instead of myType on curves driving one of the sequence's custom attributes
 		VFXCurveProfiles myCurveProfile = VFXCurveProfiles::Smooth;
 
 		float myMinValue = 0.0f;
@@ -152,8 +180,9 @@ namespace KE
 		bool visible = true;
 
 		const char* GetName() { return VFXAttributeTypeNames[(int)myType]; }
-		bool IsValid() const { return myType != VFXAttributeTypes::Count; }
+		bool IsValid() const { return myType != VFXAttributeTypes::Count || myCustomIndex >= 0; }
 		float GetEvaluatedValue(int aFrameIndex, int aFirstFrameIndex, int aLastFrameIndex) const;
+		bool IsConstantBetween(int aFrameIndex, int anOtherFrameIndex, int aFirstFrameIndex, int aLastFrameIndex) const;
 	};
 
 	struct VFXTimeStamp
@@ -165,7 +194,12 @@ namespace KE
 		VFXType myType = VFXType::Count;
 
 		bool myIsOpened = false;
+		uint32_t myLODHiddenMask = 0; //bit n hides it at lod level n + 1, kept here so it follows the timestamp when the sequencer moves or deletes it
 		std::array<KE::VFXCurveDataSet, (size_t)KE::VFXAttributeTypes::Count> myCurveDataSets;
+		std::array<KE::VFXCurveDataSet, VFX_MAX_CUSTOM_ATTRIBUTES> myCustomCurveDataSets; //indexed like the sequence's custom attributes
+
+		//true if every curve evaluates to the same value at both frames and everything in between
+		bool IsConstantBetween(int aFrame, int anOtherFrame) const;
 	};
 
 	struct VFXRenderInput
@@ -181,6 +215,15 @@ namespace KE
 		bool looping = false;
 		bool isStationary = false;
 		bool bloom = true;
+
+		//stationary looping inputs can share one simulated timeline with every other placement of the same sequence
+		bool sharedSimulation = false;
+		int sharedPhaseVariants = 1;
+
+		//starts the sequence at startFrame, prewarm also fills looping emitters with the previous loop's particles
+		bool prewarm = false;
+		int startFrame = 0;
+
 		Vector3f scaleOverride = { -1.0f, -1.0f, -1.0f };
 
 		VFXCustomBufferInput customBufferInput;
@@ -195,6 +238,32 @@ namespace KE
 		ParticleEmitter myEmitter;
 		int myStartFrame = 0;
 		int myEndFrame = 0;
+		bool myIsLODHidden = false;
+
+		//only set on a player's copies
+		int myTemplateIndex = -1;
+		int myTimestampIndex = -1;
+	};
+
+	struct VFXLODLevel
+	{
+		float myDistance = 50.0f;
+		float myParticleMultiplier = 1.0f;
+	};
+
+	struct VFXBudget
+	{
+		int myMaxParticles = 2048;
+		int myMaxMeshPackages = 8;
+		int myMaxDrawCalls = 24;
+		float myMaxScreenCoverage = 1.5f;
+	};
+
+	//a named float the sequence's shaders read from the per instance buffer, timestamps without a curve for it get the default
+	struct VFXCustomAttribute
+	{
+		std::string myName;
+		float myDefaultValue = 0.0f;
 	};
 
 	struct VFXSequence
@@ -207,25 +276,34 @@ namespace KE
 		std::vector<VFXEmitter> myParticleEmitters;
 		std::vector<VFXTimeStamp> myTimestamps;
 
-		VFXManager* myManager = nullptr;
+		//level 0 is the full sequence, level n uses myLODLevels[n - 1]. sorted by distance
+		std::vector<VFXLODLevel> myLODLevels;
 
-		void AddVFXMeshInstance();
-		void AddParticleEmitter();
-	};
+		//checked against the worst case cost estimate while authoring and in asset validation
+		VFXBudget myBudget;
 
-	struct VFXSequencePlayerData
-	{
-		VFXRenderInput myRenderInput;
-		eRenderLayers myLayer;
+		//at most VFX_MAX_CUSTOM_ATTRIBUTES, the index is the slot in VFXBufferData::customAttributes
+		std::vector<VFXCustomAttribute> myCustomAttributes;
 
-		std::vector<bool> myTimestampTriggerInfo;
-		std::vector<VFXEmitter> myEmitters;
+		//bumped whenever the sequence is loaded or edited, players drop their cached packages when it changes
+		uint32_t myRevision = 0;
 
-		int mySequenceIndex;
-		float myTimer;
-		int myFrame;
-		bool myIsLooping;
-		bool myIsWaitingOnParticles = false;
+		VFXManager* myManager = nullptr;
+
+		void AddVFXMeshInstance();
+		void AddParticleEmitter();
+		bool AddCustomAttribute(const std::string& aName, float aDefaultValue = 0.0f);
+		void RemoveCustomAttribute(int anIndex);
+		int GetCustomAttributeIndex(const std::string& aName) const;
+
+		const VFXLODLevel* GetLODLevel(int aLODLevel) const;
+		int SelectLODLevel(float aDistance, int aCurrentLODLevel) const;
+		void SortLODLevels();
+		void RemoveLODLevel(int anIndex);
+
+		//lod levels count from 1 like GetLODLevel, 0 is full detail and hides nothing
+		bool IsTimestampHidden(int aLODLevel, int aTimestampIndex) const;
+		void SetTimestampHidden(int aLODLevel, int aTimestampIndex, bool aHidden);
 	};
 
 	struct VFXSequenceRenderPackage
@@ -234,6 +312,7 @@ namespace KE
 		Transform instanceTransform;
 		eRenderLayers layer;
 		VFXCustomBufferInput customBuffer;
+		VFXMeshPasses passes;
 
 		struct
 		{
@@ -243,11 +322,183 @@ namespace KE
 			Vector3f scale = { 1.0f,1.0f,1.0f };
 			Vector4f colour = { 1.0f,1.0f,1.0f,1.0f };
 			Vector2f uvScale = { 1.0f,1.0f };
+			std::array<float, VFX_MAX_CUSTOM_ATTRIBUTES> custom{};
 		} attributes;
 
 		bool bloom = true;
 	};
 
+	//what a player's packages were built from last tick, packages are reused for as long as none of it changes
+	struct VFXPackageCache
+	{
+		std::vector<VFXSequenceRenderPackage> myPackages;
+		std::vector<int> myTimestamps; //timestamp each package came from
+		DirectX::XMFLOAT4X4 myTransform = {};
+		uint32_t mySequenceRevision = 0;
+		int myFrame = -1; //-1 until the first build
+		int myLODLevel = 0;
+	};
+
+	struct VFXSequencePlayerData
+	{
+		VFXRenderInput myRenderInput;
+		eRenderLayers myLayer;
+
+		std::vector<VFXEmitter> myEmitters; //only the emitters whose window is currently open or draining
+		VFXPackageCache myPackageCache;
+
+		VFXInstanceHandle myHandle = VFX_INVALID_HANDLE;
+
+		int mySequenceIndex;
+		float myTimer;
+		int myFrame;
+		int myLODLevel = 0;
+		bool myIsLooping;
+		bool myIsWaitingOnParticles = false;
+	};
+
+	struct VFXSharedPlacement
+	{
+		VFXRenderInput myRenderInput;
+		VFXInstanceHandle myHandle;
+	};
+
+	struct VFXSharedSimulation
+	{
+		VFXSequencePlayerData myPlayerData;
+		std::vector<VFXSharedPlacement> myPlacements;
+		int myPhaseOffset = 0;
+	};
+
+	//emitter batches are sized to their capacity, a dead particle keeps its slot collapsed to zero scale
+	bool IsVFXParticleAlive(decltype(SpriteBatch::myInstances)::value_type& anInstance);
+	int GetVFXLiveParticleCount(SpriteBatch& aBatch);
+
+	struct VFXSpriteBatchGroup
+	{
+		SpriteBatch myBatch;
+		eRenderLayers myLayer = eRenderLayers::Main;
+
+		//number of emitter batches merged into this group's single draw
+		int mySourceBatchCount = 0;
+	};
+
+	struct VFXView
+	{
+		Camera* myCamera = nullptr;
+		float myCullDistance = FLT_MAX;
+		Vector3f myPosition; //taken from the camera every frame unless the manager has a position override
+	};
+
+	struct VFXViewSubmission
+	{
+		std::optional<Camera> myCamera; //copied when the frame is built, the live camera moves on while the frame renders
+		std::vector<int> myPackageIndices; //back to front
+		VFXScreenRect myBloomRect; //empty when nothing blooms in this view
+	};
+
+	struct VFXRenderSnapshot
+	{
+		std::vector<VFXSequenceRenderPackage> myRenderPackages;
+		std::vector<VFXSpriteBatchGroup> mySpriteBatchGroups;
+		std::vector<VFXViewSubmission> myViewSubmissions;
+		std::vector<VFXBloomContributor> myBloomContributors;
+		size_t mySubmittedPackageCount = 0;
+	};
+
+	//things a snapshot the render thread is still drawing can point into, kept whole until it has moved past them
+	struct VFXRetiredResources
+	{
+		uint64_t myRenderFence = 0; //0 until the first frame that doesn't use them is published
+		std::vector<VFXMeshInstance> myMeshes;
+		std::vector<std::unique_ptr<Texture>> myAtlasPages;
+	};
+
+	enum class VFXMemoryCategory
+	{
+		Curves,
+		Timestamps,
+		MeshInstances,
+		EmitterTemplates,
+		PlayerState,
+		EmitterInstances,
+		RenderPackages,
+
+		Count
+	};
+
+	static const char* VFXMemoryCategoryNames[(int)VFXMemoryCategory::Count] =
+	{
+		"Curves",
+		"Timestamps",
+		"Mesh Instances",
+		"Emitter Templates",
+		"Player State",
+		"Emitter Instances",
+		"Render Packages",
+	};
+
+	struct VFXMemoryUsage
+	{
+		std::array<size_t, (size_t)VFXMemoryCategory::Count> myBytes{};
+
+		size_t GetTotal() const;
+	};
+
+	struct VFXMemoryStats
+	{
+		VFXMemoryUsage myCurrent;
+		VFXMemoryUsage myPeak; //per category, the categories don't have to peak on the same frame
+		size_t myPeakTotal = 0;
+
+		//indexed by sequence, render packages are shared between sequences and only show up in the totals
+		std::vector<VFXMemoryUsage> mySequences;
+		std::vector<size_t> mySequencePeaks;
+	};
+
+	//whether a sequence's data is loaded and who keeps it that way. evicted sequences keep their slot, name and index
+	struct VFXSequenceResidency
+	{
+		int myHolderCount = 0; //VFXPlayerInterface entries, editors and other explicit acquires
+		int myPlayerCount = 0; //live players and shared simulations, counted every update
+		uint64_t myLastUsedFrame = 0;
+		size_t myBytes = 0; //measured when loaded, only what the manager owns, models and textures belong to the asset system
+		bool myIsResident = true;
+		bool myIsEvictable = false; //only sequences backed by a file or pack entry can be loaded again
+	};
+
+	struct VFXResidencyStats
+	{
+		int myResidentCount = 0;
+		int myEvictedCount = 0;
+		size_t myResidentBytes = 0;
+		size_t myBudget = 0;
+
+		//since startup
+		int myEvictions = 0;
+		int myReloads = 0;
+	};
+
+	enum class VFXReloadMode
+	{
+		None,
+		Changed, //only what changed on disk since it was loaded
+		Full, //everything, unsaved edits included
+	};
+
+	//what a sequence was loaded from, reloads diff against the hashes and only rebuild what changed
+	struct VFXSequenceSource
+	{
+		std::string myFilePath;
+		std::filesystem::file_time_type myWriteTime;
+		VFXReloadMode myPendingReload = VFXReloadMode::None; //pipelined reloads wait for EndFrame so the frame being built can be rebuilt on the new meshes
+
+		std::vector<size_t> myMeshHashes;
+		std::vector<size_t> myEmitterResourceHashes; //capacity and texture, a change needs a new sprite batch
+		std::vector<size_t> myEmitterAttributeHashes;
+		std::vector<size_t> myTimestampHashes;
+	};
+
 	class VFXMeshInstance
 	{
 		friend class VFXManager;
@@ -255,6 +506,8 @@ namespace KE
 		Transform myTransform;
 
 		ModelData myModelData;
+		VFXMeshShape myShape = VFXMeshShape::Closed; //analyzed when the model is loaded
+		VFXMeshDrawMode myDrawMode = VFXMeshDrawMode::Auto;
 	public:
 		VFXMeshInstance() = default;
 		~VFXMeshInstance() = default;
@@ -262,5 +515,10 @@ namespace KE
 		inline void SetModelData(const ModelData& aModelData) { myModelData = aModelData; }
 		inline ModelData* GetModelData() { return &myModelData; }
 		inline Transform* GetTransform() { return &myTransform; }
+
+		inline VFXMeshShape GetShape() const { return myShape; }
+		inline VFXMeshDrawMode GetDrawMode() const { return myDrawMode; }
+		inline void SetDrawMode(VFXMeshDrawMode aDrawMode) { myDrawMode = aDrawMode; }
+		inline VFXMeshPasses GetPasses() const { return GetVFXMeshPasses(myShape, myDrawMode); }
 	};
 }
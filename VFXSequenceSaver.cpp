@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "VFXSequenceSaver.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Engine/Source/Graphics/FX/VFXResources.h"
+
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	static bool WriteAndReplace(const std::string& aFilePath, const std::string& aContents)
+	{
+		const std::string tempPath = aFilePath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) { return false; }
+
+			file.write(aContents.data(), aContents.size());
+			file.flush();
+			if (!file.good())
+			{
+				file.close();
+				std::error_code error;
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, aFilePath, error);
+		if (error)
+		{
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+		return true;
+	}
+
+	VFXSaveStatus WriteVFXSequenceFile(const std::string& aSequenceName, const nlohmann::json& aSnapshot, std::string& outFilePath)
+	{
+		const std::string contents = aSnapshot.dump(4);
+
+		outFilePath = VFX_SEQUENCE_FILE_LOCATION + aSequenceName + ".kittyVFX";
+		if (WriteAndReplace(outFilePath, contents)) { return VFXSaveStatus::Written; }
+
+		KE_ERROR("Failed to save sequence %s", aSequenceName.c_str());
+		for (int i = 0; i < 128; i++)
+		{
+			outFilePath = VFX_SEQUENCE_FILE_LOCATION + aSequenceName + std::format("backupSave_{}.kittyVFX", i);
+			if (!std::filesystem::exists(outFilePath) && WriteAndReplace(outFilePath, contents)) { return VFXSaveStatus::WrittenToBackup; }
+		}
+
+		outFilePath.clear();
+		return VFXSaveStatus::Failed;
+	}
+
+	VFXSequenceSaver::VFXSequenceSaver()
+	{
+		myWorker = std::thread(&VFXSequenceSaver::Run, this);
+	}
+
+	VFXSequenceSaver::~VFXSequenceSaver()
+	{
+		{
+			std::lock_guard lock(myMutex);
+			myIsRunning = false;
+		}
+		myWakeCondition.notify_one();
+
+		//whatever is still queued gets written before the worker exits
+		myWorker.join();
+	}
+
+	void VFXSequenceSaver::Save(int aSequenceIndex, const std::string& aSequenceName, nlohmann::json&& aSnapshot)
+	{
+		{
+			std::lock_guard lock(myMutex);
+
+			auto pending = std::ranges::find_if(myPending, [&aSequenceName](const PendingSave& aSave) { return aSave.sequenceName == aSequenceName; });
+			if (pending != myPending.end())
+			{
+				pending->snapshot = std::move(aSnapshot);
+				pending->coalescedSaves++;
+				return;
+			}
+
+			myPending.push_back({ aSequenceIndex, aSequenceName, std::move(aSnapshot) });
+		}
+		myWakeCondition.notify_one();
+	}
+
+	void VFXSequenceSaver::Run()
+	{
+		std::unique_lock lock(myMutex);
+		while (true)
+		{
+			myWakeCondition.wait(lock, [this] { return !myPending.empty() || !myIsRunning; });
+			if (myPending.empty()) { return; }
+
+			PendingSave save = std::move(myPending.front());
+			myPending.pop_front();
+			myIsWriting = true;
+			myWritingIndex = save.sequenceIndex;
+			lock.unlock();
+
+			VFXSaveResult result;
+			result.sequenceIndex = save.sequenceIndex;
+			result.sequenceName = save.sequenceName;
+			result.coalescedSaves = save.coalescedSaves;
+			result.status = WriteVFXSequenceFile(save.sequenceName, save.snapshot, result.filePath);
+			result.snapshot = std::move(save.snapshot);
+
+			lock.lock();
+			myIsWriting = false;
+			myWritingIndex = -1;
+			myResults.push_back(std::move(result));
+			if (myPending.empty()) { myIdleCondition.notify_all(); }
+		}
+	}
+
+	std::vector<VFXSaveResult> VFXSequenceSaver::DispatchResults()
+	{
+		std::vector<VFXSaveResult> results;
+		VFXSaveCallback callback;
+		{
+			std::lock_guard lock(myMutex);
+			if (myResults.empty()) { return results; }
+
+			results.swap(myResults);
+			callback = myCallback;
+		}
+
+		for (const VFXSaveResult& result : results)
+		{
+			if (result.status == VFXSaveStatus::Failed)
+			{
+				KE_ERROR("Failed to save sequence %s (%i), no backup could be written either", result.sequenceName.c_str(), result.sequenceIndex);
+			}
+			if (callback) { callback(result); }
+			myLastResults[result.sequenceIndex] = { result.sequenceIndex, result.sequenceName, result.filePath, result.status, result.coalescedSaves };
+		}
+		return results;
+	}
+
+	const VFXSaveResult* VFXSequenceSaver::GetLastResult(int aSequenceIndex) const
+	{
+		const auto it = myLastResults.find(aSequenceIndex);
+		return it != myLastResults.end() ? &it->second : nullptr;
+	}
+
+	void VFXSequenceSaver::Flush()
+	{
+		std::unique_lock lock(myMutex);
+		myIdleCondition.wait(lock, [this] { return myPending.empty() && !myIsWriting; });
+	}
+
+	bool VFXSequenceSaver::IsSaving(int aSequenceIndex) const
+	{
+		std::lock_guard lock(myMutex);
+		if (aSequenceIndex < 0) { return myIsWriting || !myPending.empty() || !myResults.empty(); }
+
+		if (myIsWriting && myWritingIndex == aSequenceIndex) { return true; }
+		return std::ranges::any_of(myPending, [aSequenceIndex](const PendingSave& aSave) { return aSave.sequenceIndex == aSequenceIndex; }) ||
+			std::ranges::any_of(myResults, [aSequenceIndex](const VFXSaveResult& aResult) { return aResult.sequenceIndex == aSequenceIndex; });
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <External/Include/nlohmann/json.hpp>
+
+namespace KE
+{
+	enum class VFXSaveStatus
+	{
+		Written,
+		WrittenToBackup, //the sequence file couldn't be replaced, the save went to a backupSave_ file next to it
+		Failed,
+	};
+
+	struct VFXSaveResult
+	{
+		int sequenceIndex = -1;
+		std::string sequenceName;
+		std::string filePath;
+		VFXSaveStatus status = VFXSaveStatus::Failed;
+		int coalescedSaves = 0; //saves of the same sequence that were replaced before the worker got to them
+		nlohmann::json snapshot; //what was written, only kept in the results DispatchResults returns
+	};
+
+	using VFXSaveCallback = std::function<void(const VFXSaveResult&)>;
+
+	//writes to a temp file next to the target and renames it over the target, a crash mid write leaves the old file intact
+	VFXSaveStatus WriteVFXSequenceFile(const std::string& aSequenceName, const nlohmann::json& aSnapshot, std::string& outFilePath);
+
+	//serializes and writes sequence snapshots on a worker thread.
+	//a save of a sequence that is still waiting replaces the waiting snapshot, so holding ctrl+s only writes the latest one
+	class VFXSequenceSaver
+	{
+	private:
+		struct PendingSave
+		{
+			int sequenceIndex = -1;
+			std::string sequenceName;
+			nlohmann::json snapshot;
+			int coalescedSaves = 0;
+		};
+
+		std::thread myWorker;
+		mutable std::mutex myMutex;
+		std::condition_variable myWakeCondition;
+		std::condition_variable myIdleCondition;
+
+		std::deque<PendingSave> myPending;
+		std::vector<VFXSaveResult> myResults;
+		std::unordered_map<int, VFXSaveResult> myLastResults; //by sequence index, only touched by the dispatching thread
+		VFXSaveCallback myCallback;
+		int myWritingIndex = -1;
+		bool myIsWriting = false;
+		bool myIsRunning = true;
+
+		void Run();
+
+	public:
+		VFXSequenceSaver();
+		~VFXSequenceSaver();
+
+		VFXSequenceSaver(const VFXSequenceSaver&) = delete;
+		VFXSequenceSaver& operator=(const VFXSequenceSaver&) = delete;
+
+		void Save(int aSequenceIndex, const std::string& aSequenceName, nlohmann::json&& aSnapshot);
+
+		//the callback runs on the thread calling DispatchResults, not on the worker
+		inline void SetCallback(VFXSaveCallback aCallback) { std::lock_guard lock(myMutex); myCallback = std::move(aCallback); }
+		std::vector<VFXSaveResult> DispatchResults();
+		const VFXSaveResult* GetLastResult(int aSequenceIndex) const;
+
+		//blocks until every queued save has been written
+		void Flush();
+		//a written save counts until its result is dispatched
+		bool IsSaving(int aSequenceIndex = -1) const;
+	};
+}
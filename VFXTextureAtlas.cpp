@@ -0,0 +1,225 @@
+#include "stdafx.h"
+#include "VFXTextureAtlas.h"
+
+#include "Engine/Source/Graphics/Graphics.h"
+
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	std::vector<VFXAtlasRect> PackVFXAtlas(std::span<const VFXAtlasSize> aSizes, int aPageSize, int aPadding)
+	{
+		std::vector<VFXAtlasRect> rects(aSizes.size());
+
+		//tallest first keeps the shelves tight
+		std::vector<int> order(aSizes.size());
+		for (int i = 0; i < order.size(); i++) { order[i] = i; }
+		std::ranges::stable_sort(order, [&aSizes](int a, int b) { return aSizes[a].height > aSizes[b].height; });
+
+		int page = 0;
+		VFXAtlasShelf shelf;
+
+		for (const int index : order)
+		{
+			if (!PlaceOnVFXAtlasShelf(shelf, aSizes[index], rects[index], aPageSize, aPadding))
+			{
+				//anything that doesn't fit an empty page never will
+				VFXAtlasShelf emptyShelf;
+				if (!PlaceOnVFXAtlasShelf(emptyShelf, aSizes[index], rects[index], aPageSize, aPadding)) { continue; }
+				shelf = emptyShelf;
+				page++;
+			}
+			rects[index].page = page;
+		}
+
+		return rects;
+	}
+
+	bool PlaceOnVFXAtlasShelf(VFXAtlasShelf& aShelf, const VFXAtlasSize& aSize, VFXAtlasRect& outRect, int aPageSize, int aPadding)
+	{
+		const auto align = [aPadding](int aValue)
+		{
+			return aPadding > 0 ? (aValue + aPadding - 1) / aPadding * aPadding : aValue;
+		};
+
+		const int paddedWidth = align(aSize.width) + aPadding;
+		const int paddedHeight = align(aSize.height) + aPadding;
+		if (aSize.width <= 0 || aSize.height <= 0 || paddedWidth > aPageSize || paddedHeight > aPageSize)
+		{
+			return false;
+		}
+
+		VFXAtlasShelf shelf = aShelf;
+		if (shelf.x + paddedWidth > aPageSize)
+		{
+			shelf.x = 0;
+			shelf.y += shelf.height;
+			shelf.height = 0;
+		}
+		if (shelf.y + paddedHeight > aPageSize)
+		{
+			return false;
+		}
+
+		outRect.x = shelf.x;
+		outRect.y = shelf.y;
+		outRect.width = aSize.width;
+		outRect.height = aSize.height;
+
+		shelf.x += paddedWidth;
+		shelf.height = std::max(shelf.height, paddedHeight);
+		aShelf = shelf;
+		return true;
+	}
+
+	Vector4f GetVFXAtlasUVTransform(const VFXAtlasRect& aRect, int aPageSize)
+	{
+		const float pageSize = static_cast<float>(aPageSize);
+		return {
+			static_cast<float>(aRect.x) / pageSize,
+			static_cast<float>(aRect.y) / pageSize,
+			static_cast<float>(aRect.width) / pageSize,
+			static_cast<float>(aRect.height) / pageSize
+		};
+	}
+
+	Vector4f RemapVFXAtlasUV(const Vector4f& aSamplingData, const Vector4f& aUVTransform)
+	{
+		return {
+			aUVTransform.x + aSamplingData.x * aUVTransform.z,
+			aUVTransform.y + aSamplingData.y * aUVTransform.w,
+			aSamplingData.z * aUVTransform.z,
+			aSamplingData.w * aUVTransform.w
+		};
+	}
+
+	VFXTextureAtlas::VFXTextureAtlas() = default;
+	VFXTextureAtlas::~VFXTextureAtlas() = default;
+
+	void VFXTextureAtlas::Update(Graphics* aGraphics, std::span<Texture* const> aTextures, std::vector<std::unique_ptr<Texture>>& someOutRetiredPages)
+	{
+		//textures nothing uses anymore give up their place, pages left empty are handed back
+		for (auto it = myEntries.begin(); it != myEntries.end();)
+		{
+			if (std::ranges::find(aTextures, it->first) != aTextures.end())
+			{
+				++it;
+				continue;
+			}
+
+			Page& page = *std::ranges::find_if(myPages, [&it](const Page& aPage) { return aPage.texture.get() == it->second.page; });
+			page.textureCount--;
+			it = myEntries.erase(it);
+		}
+		for (Page& page : myPages)
+		{
+			if (page.textureCount == 0) { someOutRetiredPages.push_back(std::move(page.texture)); }
+		}
+		std::erase_if(myPages, [](const Page& aPage) { return aPage.textureCount == 0; });
+
+		ID3D11DeviceContext* context = aGraphics->GetContext().Get();
+
+		struct AtlasSource
+		{
+			Texture* texture;
+			Microsoft::WRL::ComPtr<ID3D11Texture2D> resource;
+			D3D11_TEXTURE2D_DESC desc;
+		};
+
+		//pages can't mix formats, so every format gets packed on its own
+		std::unordered_map<DXGI_FORMAT, std::vector<AtlasSource>> sourcesByFormat;
+		for (Texture* texture : aTextures)
+		{
+			if (!texture || !texture->myShaderResourceView || myEntries.contains(texture)) { continue; }
+
+			Microsoft::WRL::ComPtr<ID3D11Resource> resource;
+			texture->myShaderResourceView->GetResource(&resource);
+
+			AtlasSource source{ texture };
+			if (FAILED(resource.As(&source.resource))) { continue; }
+
+			source.resource->GetDesc(&source.desc);
+			if (source.desc.ArraySize != 1 || source.desc.SampleDesc.Count != 1) { continue; }
+
+			sourcesByFormat[source.desc.Format].push_back(source);
+		}
+
+		for (auto& [format, sources] : sourcesByFormat)
+		{
+			//the newest page of a format is the only one with room left
+			const auto openPage = std::ranges::find_if(myPages.rbegin(), myPages.rend(), [format](const Page& aPage) { return aPage.format == format; });
+			Page* page = openPage != myPages.rend() ? &*openPage : nullptr;
+
+			//a lone texture doesn't batch with anything, it waits for a second one of its format
+			if (!page && sources.size() < 2) { continue; }
+
+			//tallest first keeps the shelves tight
+			std::ranges::stable_sort(sources, [](const AtlasSource& a, const AtlasSource& b) { return a.desc.Height > b.desc.Height; });
+
+			for (const AtlasSource& source : sources)
+			{
+				const VFXAtlasSize size = { static_cast<int>(source.desc.Width), static_cast<int>(source.desc.Height) };
+				VFXAtlasRect rect;
+				if (!page || !PlaceOnVFXAtlasShelf(page->shelf, size, rect))
+				{
+					VFXAtlasShelf emptyShelf;
+					if (!PlaceOnVFXAtlasShelf(emptyShelf, size, rect)) { continue; }
+
+					page = CreatePage(aGraphics, format);
+					if (!page) { return; }
+					page->shelf = emptyShelf;
+				}
+
+				Microsoft::WRL::ComPtr<ID3D11Resource> pageResource;
+				page->texture->myShaderResourceView->GetResource(&pageResource);
+
+				//only the top mip is copied, particles don't sample far enough away for the rest to matter
+				context->CopySubresourceRegion(
+					pageResource.Get(), 0,
+					rect.x, rect.y, 0,
+					source.resource.Get(), 0,
+					nullptr
+				);
+
+				myEntries[source.texture] = { page->texture.get(), GetVFXAtlasUVTransform(rect) };
+				page->textureCount++;
+			}
+		}
+	}
+
+	VFXTextureAtlas::Page* VFXTextureAtlas::CreatePage(Graphics* aGraphics, DXGI_FORMAT aFormat)
+	{
+		D3D11_TEXTURE2D_DESC pageDesc = {};
+		pageDesc.Width = VFX_ATLAS_PAGE_SIZE;
+		pageDesc.Height = VFX_ATLAS_PAGE_SIZE;
+		pageDesc.MipLevels = 1;
+		pageDesc.ArraySize = 1;
+		pageDesc.Format = aFormat;
+		pageDesc.SampleDesc.Count = 1;
+		pageDesc.Usage = D3D11_USAGE_DEFAULT;
+		pageDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		ID3D11Device* device = aGraphics->GetDevice().Get();
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> pageResource;
+		auto texture = std::make_unique<Texture>();
+		if (FAILED(device->CreateTexture2D(&pageDesc, nullptr, &pageResource)) ||
+			FAILED(device->CreateShaderResourceView(pageResource.Get(), nullptr, &texture->myShaderResourceView)))
+		{
+			KE_ERROR("Failed to create VFX atlas page %i", GetPageCount());
+			return nullptr;
+		}
+
+		texture->myMetadata.myFilePath = std::format("VFXAtlasPage_{}", GetPageCount());
+
+		Page& page = myPages.emplace_back();
+		page.texture = std::move(texture);
+		page.format = aFormat;
+		return &page;
+	}
+
+	const VFXAtlasEntry* VFXTextureAtlas::Find(const Texture* aTexture) const
+	{
+		const auto it = myEntries.find(aTexture);
+		return it != myEntries.end() ? &it->second : nullptr;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <dxgiformat.h>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Source/Math/KittyMath.h"
+
+namespace KE
+{
+	class Graphics;
+	class Texture;
+
+	constexpr int VFX_ATLAS_PAGE_SIZE = 2048;
+	constexpr int VFX_ATLAS_PADDING = 4; //also keeps every rect aligned to block compressed 4x4 blocks
+
+	struct VFXAtlasSize
+	{
+		int width = 0;
+		int height = 0;
+	};
+
+	struct VFXAtlasRect
+	{
+		int page = -1; //-1 if the texture didn't fit on a page
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+	};
+
+	struct VFXAtlasEntry
+	{
+		Texture* page = nullptr;
+		Vector4f uvTransform = { 0.0f, 0.0f, 1.0f, 1.0f }; //xy offset, zw scale
+	};
+
+	//where the next rect goes on a page
+	struct VFXAtlasShelf
+	{
+		int x = 0;
+		int y = 0;
+		int height = 0;
+	};
+
+	//shelf packs the sizes onto square pages, rects are returned in the same order as the sizes
+	std::vector<VFXAtlasRect> PackVFXAtlas(std::span<const VFXAtlasSize> aSizes, int aPageSize = VFX_ATLAS_PAGE_SIZE, int aPadding = VFX_ATLAS_PADDING);
+	//places the size on the shelf's page, false if the page is full. the shelf is left as it was then
+	bool PlaceOnVFXAtlasShelf(VFXAtlasShelf& aShelf, const VFXAtlasSize& aSize, VFXAtlasRect& outRect, int aPageSize = VFX_ATLAS_PAGE_SIZE, int aPadding = VFX_ATLAS_PADDING);
+	Vector4f GetVFXAtlasUVTransform(const VFXAtlasRect& aRect, int aPageSize = VFX_ATLAS_PAGE_SIZE);
+	Vector4f RemapVFXAtlasUV(const Vector4f& aSamplingData, const Vector4f& aUVTransform);
+
+	class VFXTextureAtlas
+	{
+	private:
+		struct Page
+		{
+			std::unique_ptr<Texture> texture;
+			DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+			VFXAtlasShelf shelf;
+			int textureCount = 0;
+		};
+
+		std::vector<Page> myPages;
+		std::unordered_map<const Texture*, VFXAtlasEntry> myEntries;
+
+		Page* CreatePage(Graphics* aGraphics, DXGI_FORMAT aFormat);
+
+	public:
+		VFXTextureAtlas();
+		~VFXTextureAtlas();
+
+		//only copies in the textures that aren't on a page yet. space freed by textures no longer in the list isn't reused,
+		//a page goes to someOutRetiredPages once none of its textures are left, frames already built can still sample it
+		void Update(Graphics* aGraphics, std::span<Texture* const> aTextures, std::vector<std::unique_ptr<Texture>>& someOutRetiredPages);
+
+		const VFXAtlasEntry* Find(const Texture* aTexture) const;
+		inline int GetPageCount() const { return static_cast<int>(myPages.size()); }
+		inline int GetTextureCount() const { return static_cast<int>(myEntries.size()); }
+	};
+}
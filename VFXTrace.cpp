@@ -0,0 +1,421 @@
+#include "stdafx.h"
+#include "VFXTrace.h"
+
+#include <chrono>
+#include <fstream>
+
+#include "VFXManager.h"
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	namespace
+	{
+		enum VFXTraceInputFlags : uint8_t
+		{
+			Looping = 1 << 0,
+			Stationary = 1 << 1,
+			Bloom = 1 << 2,
+			SharedSimulation = 1 << 3,
+			Prewarm = 1 << 4,
+		};
+
+		constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+		constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+		void HashBytes(uint64_t& aHash, const void* aData, size_t aSize)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(aData);
+			for (size_t i = 0; i < aSize; i++)
+			{
+				aHash = (aHash ^ bytes[i]) * FNV_PRIME;
+			}
+		}
+	}
+
+	uint64_t HashVFXRenderPackages(std::span<const VFXSequenceRenderPackage> aPackages)
+	{
+		uint64_t hash = FNV_OFFSET;
+		for (const VFXSequenceRenderPackage& package : aPackages)
+		{
+			DirectX::XMFLOAT4X4 matrix;
+			DirectX::XMStoreFloat4x4(&matrix, const_cast<Transform&>(package.instanceTransform).GetMatrix());
+			HashBytes(hash, &matrix, sizeof(matrix));
+
+			const auto& attributes = package.attributes;
+			for (const float value : {
+				attributes.uvOffset.x, attributes.uvOffset.y,
+				attributes.translation.x, attributes.translation.y, attributes.translation.z,
+				attributes.rotation.x, attributes.rotation.y, attributes.rotation.z,
+				attributes.scale.x, attributes.scale.y, attributes.scale.z,
+				attributes.colour.x, attributes.colour.y, attributes.colour.z, attributes.colour.w,
+				attributes.uvScale.x, attributes.uvScale.y })
+			{
+				HashBytes(hash, &value, sizeof(value));
+			}
+			HashBytes(hash, attributes.custom.data(), attributes.custom.size() * sizeof(float));
+
+			const uint8_t layer = (uint8_t)package.layer;
+			const uint8_t bloom = package.bloom ? 1 : 0;
+			HashBytes(hash, &layer, sizeof(layer));
+			HashBytes(hash, &bloom, sizeof(bloom));
+		}
+		return hash;
+	}
+
+	template<typename T>
+	void VFXTraceRecorder::Write(const T& aValue)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		const size_t offset = myData.size();
+		myData.resize(offset + sizeof(T));
+		std::memcpy(myData.data() + offset, &aValue, sizeof(T));
+	}
+
+	void VFXTraceRecorder::Begin()
+	{
+		myData.clear();
+		myRecordedSequences.clear();
+		myTransformIds.clear();
+		myTransformMatrices.clear();
+
+		Write(VFX_TRACE_MAGIC);
+		Write(VFX_TRACE_VERSION);
+	}
+
+	void VFXTraceRecorder::WriteSequence(int aSequenceIndex, const std::string& aSequenceName)
+	{
+		if (aSequenceIndex < myRecordedSequences.size() && myRecordedSequences[aSequenceIndex]) { return; }
+
+		if (aSequenceIndex >= myRecordedSequences.size()) { myRecordedSequences.resize(aSequenceIndex + 1, false); }
+		myRecordedSequences[aSequenceIndex] = true;
+
+		Write(VFXTraceEvent::Sequence);
+		Write((int32_t)aSequenceIndex);
+		Write((uint16_t)aSequenceName.size());
+		myData.insert(myData.end(), aSequenceName.begin(), aSequenceName.end());
+	}
+
+	uint32_t VFXTraceRecorder::WriteTransform(const Transform* aTransform)
+	{
+		DirectX::XMFLOAT4X4 matrix;
+		DirectX::XMStoreFloat4x4(&matrix, const_cast<Transform*>(aTransform)->GetMatrix());
+
+		auto [it, isNew] = myTransformIds.try_emplace(aTransform, (uint32_t)myTransformMatrices.size() + 1);
+		const uint32_t id = it->second;
+		if (isNew)
+		{
+			myTransformMatrices.push_back(matrix);
+		}
+		else if (std::memcmp(&myTransformMatrices[id - 1], &matrix, sizeof(matrix)) == 0)
+		{
+			return id;
+		}
+
+		myTransformMatrices[id - 1] = matrix;
+		Write(VFXTraceEvent::Transform);
+		Write(id);
+		Write(matrix);
+		return id;
+	}
+
+	void VFXTraceRecorder::RecordFrameBegin(float aDeltaTime, std::span<const VFXView> aViews)
+	{
+		Write(VFXTraceEvent::FrameBegin);
+		Write(aDeltaTime);
+		Write((uint8_t)aViews.size());
+		for (const VFXView& view : aViews)
+		{
+			Write(view.myPosition);
+		}
+	}
+
+	void VFXTraceRecorder::RecordAttachedTransform(const Transform* aTransform)
+	{
+		WriteTransform(aTransform);
+	}
+
+	void VFXTraceRecorder::RecordFrameEnd(std::span<const VFXSequenceRenderPackage> aPackages)
+	{
+		Write(VFXTraceEvent::FrameEnd);
+		Write(HashVFXRenderPackages(aPackages));
+		Write((uint32_t)aPackages.size());
+	}
+
+	void VFXTraceRecorder::RecordTrigger(int aSequenceIndex, const std::string& aSequenceName, const VFXRenderInput& aRenderInput, VFXInstanceHandle aHandle)
+	{
+		WriteSequence(aSequenceIndex, aSequenceName);
+		const uint32_t transformId = aRenderInput.isStationary ? 0 : WriteTransform(aRenderInput.myTransform);
+
+		uint8_t flags = 0;
+		flags |= aRenderInput.looping ? Looping : 0;
+		flags |= aRenderInput.isStationary ? Stationary : 0;
+		flags |= aRenderInput.bloom ? Bloom : 0;
+		flags |= aRenderInput.sharedSimulation ? SharedSimulation : 0;
+		flags |= aRenderInput.prewarm ? Prewarm : 0;
+
+		//custom buffers point into gameplay memory and aren't recorded
+		Write(VFXTraceEvent::Trigger);
+		Write((int32_t)aSequenceIndex);
+		Write((int32_t)aHandle);
+		Write(flags);
+		Write((uint8_t)aRenderInput.myLayer);
+		Write((int32_t)aRenderInput.sharedPhaseVariants);
+		Write((int32_t)aRenderInput.startFrame);
+		Write(aRenderInput.scaleOverride);
+
+		if (aRenderInput.isStationary)
+		{
+			DirectX::XMFLOAT4X4 matrix;
+			DirectX::XMStoreFloat4x4(&matrix, const_cast<Transform&>(aRenderInput.myStationaryTransform).GetMatrix());
+			Write(matrix);
+		}
+		else
+		{
+			Write(transformId);
+		}
+	}
+
+	void VFXTraceRecorder::RecordStop(int aSequenceIndex, const std::string& aSequenceName, const VFXRenderInput& aRenderInput)
+	{
+		//stops are matched by transform pointer, a stationary input can't match anything so it isn't worth recording
+		if (aRenderInput.isStationary) { return; }
+
+		WriteSequence(aSequenceIndex, aSequenceName);
+		const uint32_t transformId = WriteTransform(aRenderInput.myTransform);
+
+		Write(VFXTraceEvent::Stop);
+		Write((int32_t)aSequenceIndex);
+		Write(transformId);
+	}
+
+	void VFXTraceRecorder::RecordStopInstance(VFXInstanceHandle aHandle)
+	{
+		Write(VFXTraceEvent::StopInstance);
+		Write((int32_t)aHandle);
+	}
+
+	void VFXTraceRecorder::RecordSeek(VFXInstanceHandle aHandle, int aFrame)
+	{
+		Write(VFXTraceEvent::Seek);
+		Write((int32_t)aHandle);
+		Write((int32_t)aFrame);
+	}
+
+	void VFXTraceRecorder::RecordSetTransform(VFXInstanceHandle aHandle, const Transform& aTransform)
+	{
+		DirectX::XMFLOAT4X4 matrix;
+		DirectX::XMStoreFloat4x4(&matrix, const_cast<Transform&>(aTransform).GetMatrix());
+
+		Write(VFXTraceEvent::SetTransform);
+		Write((int32_t)aHandle);
+		Write(matrix);
+	}
+
+	bool VFXTraceRecorder::Save(const std::string& aFilePath) const
+	{
+		std::ofstream file(aFilePath, std::ios::binary);
+		if (!file.is_open())
+		{
+			KE_ERROR("Failed to write VFX trace %s", aFilePath.c_str());
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(myData.data()), myData.size());
+		return true;
+	}
+
+	template<typename T>
+	T VFXTraceReplay::Read()
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value{};
+		if (myCursor + sizeof(T) <= myData.size())
+		{
+			std::memcpy(&value, myData.data() + myCursor, sizeof(T));
+		}
+		myCursor += sizeof(T);
+		return value;
+	}
+
+	bool VFXTraceReplay::Load(const std::string& aFilePath)
+	{
+		std::ifstream file(aFilePath, std::ios::binary);
+		if (!file.is_open())
+		{
+			KE_ERROR("Failed to open VFX trace %s", aFilePath.c_str());
+			return false;
+		}
+
+		myData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		myCursor = 0;
+
+		if (Read<uint32_t>() != VFX_TRACE_MAGIC || Read<uint32_t>() != VFX_TRACE_VERSION)
+		{
+			KE_ERROR("%s is not a VFX trace of version %u", aFilePath.c_str(), VFX_TRACE_VERSION);
+			myData.clear();
+			return false;
+		}
+		return true;
+	}
+
+	Transform& VFXTraceReplay::GetTransform(uint32_t anId)
+	{
+		auto& transform = myTransforms[anId];
+		if (!transform) { transform = std::make_unique<Transform>(); }
+		return *transform;
+	}
+
+	VFXRenderInput VFXTraceReplay::ReadRenderInput()
+	{
+		const uint8_t flags = Read<uint8_t>();
+		const eRenderLayers layer = (eRenderLayers)Read<uint8_t>();
+		const int32_t phaseVariants = Read<int32_t>();
+		const int32_t startFrame = Read<int32_t>();
+		const Vector3f scaleOverride = Read<Vector3f>();
+
+		const bool isStationary = (flags & Stationary) != 0;
+		Transform stationaryTransform;
+		Transform* transform = &stationaryTransform;
+		if (isStationary)
+		{
+			const DirectX::XMFLOAT4X4 matrix = Read<DirectX::XMFLOAT4X4>();
+			stationaryTransform = DirectX::XMLoadFloat4x4(&matrix);
+		}
+		else
+		{
+			transform = &GetTransform(Read<uint32_t>());
+		}
+
+		VFXRenderInput input(*transform, (flags & Looping) != 0, isStationary);
+		input.myLayer = layer;
+		input.bloom = (flags & Bloom) != 0;
+		input.sharedSimulation = (flags & SharedSimulation) != 0;
+		input.prewarm = (flags & Prewarm) != 0;
+		input.sharedPhaseVariants = phaseVariants;
+		input.startFrame = startFrame;
+		input.scaleOverride = scaleOverride;
+		return input;
+	}
+
+	const std::vector<VFXReplayFrame>& VFXTraceReplay::Run()
+	{
+		myFrames.clear();
+		mySequences.clear();
+		myHandles.clear();
+		myTransforms.clear();
+		myManager.ClearVFX();
+
+		myCursor = 2 * sizeof(uint32_t);
+		while (myCursor < myData.size())
+		{
+			switch (Read<VFXTraceEvent>())
+			{
+			case VFXTraceEvent::Sequence:
+			{
+				const int32_t index = Read<int32_t>();
+				const uint16_t length = Read<uint16_t>();
+				const std::string name(reinterpret_cast<const char*>(myData.data() + myCursor), std::min<size_t>(length, myData.size() - myCursor));
+				myCursor += length;
+				mySequences[index] = myManager.GetVFXSequenceFromName(name);
+				break;
+			}
+			case VFXTraceEvent::Transform:
+			{
+				Transform& transform = GetTransform(Read<uint32_t>());
+				const DirectX::XMFLOAT4X4 matrix = Read<DirectX::XMFLOAT4X4>();
+				transform = DirectX::XMLoadFloat4x4(&matrix);
+				break;
+			}
+			case VFXTraceEvent::FrameBegin:
+			{
+				myDeltaTime = Read<float>();
+				myViewPositions.resize(Read<uint8_t>());
+				for (Vector3f& position : myViewPositions) { position = Read<Vector3f>(); }
+				break;
+			}
+			case VFXTraceEvent::FrameEnd:
+			{
+				const uint64_t hash = Read<uint64_t>();
+				const uint32_t packageCount = Read<uint32_t>();
+				ReplayFrame(hash, packageCount);
+				break;
+			}
+			case VFXTraceEvent::Trigger:
+			{
+				const int32_t sequenceIndex = Read<int32_t>();
+				const int32_t handle = Read<int32_t>();
+				const VFXRenderInput input = ReadRenderInput();
+				myHandles[handle] = myManager.TriggerVFXSequence(mySequences[sequenceIndex], input);
+				break;
+			}
+			case VFXTraceEvent::Stop:
+			{
+				const int32_t sequenceIndex = Read<int32_t>();
+				const VFXRenderInput input(GetTransform(Read<uint32_t>()));
+				myManager.StopVFXSequence(mySequences[sequenceIndex], input);
+				break;
+			}
+			case VFXTraceEvent::StopInstance:
+			{
+				const auto it = myHandles.find(Read<int32_t>());
+				if (it != myHandles.end()) { myManager.StopVFXInstance(it->second); }
+				break;
+			}
+			case VFXTraceEvent::Seek:
+			{
+				const auto it = myHandles.find(Read<int32_t>());
+				const int32_t frame = Read<int32_t>();
+				if (it != myHandles.end()) { myManager.Seek(it->second, frame); }
+				break;
+			}
+			case VFXTraceEvent::SetTransform:
+			{
+				const auto it = myHandles.find(Read<int32_t>());
+				const DirectX::XMFLOAT4X4 matrix = Read<DirectX::XMFLOAT4X4>();
+				if (it != myHandles.end())
+				{
+					Transform transform;
+					transform = DirectX::XMLoadFloat4x4(&matrix);
+					myManager.SetInstanceTransform(it->second, transform);
+				}
+				break;
+			}
+			default:
+				KE_ERROR("Corrupt VFX trace at byte %zu", myCursor);
+				myCursor = myData.size();
+				break;
+			}
+		}
+
+		myManager.SetViewPositionOverrides({});
+		myManager.ClearVFX();
+		return myFrames;
+	}
+
+	void VFXTraceReplay::ReplayFrame(uint64_t aRecordedHash, uint32_t aRecordedPackageCount)
+	{
+		//emitters step with the global delta time, it has to match the recorded one for the particles to line up
+		const float deltaTimeCache = KE_GLOBAL::deltaTime;
+		KE_GLOBAL::deltaTime = myDeltaTime;
+		myManager.SetViewPositionOverrides(myViewPositions);
+
+		const auto start = std::chrono::steady_clock::now();
+		myManager.Update(myDeltaTime);
+		const double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		const auto& packages = myManager.myRenderSnapshots[myManager.myWriteSnapshot].myRenderPackages;
+		VFXReplayFrame& frame = myFrames.emplace_back();
+		frame.updateMicroseconds = microseconds;
+		frame.packageCount = (uint32_t)packages.size();
+		frame.matches = frame.packageCount == aRecordedPackageCount && HashVFXRenderPackages(packages) == aRecordedHash;
+
+		myManager.EndFrame();
+		KE_GLOBAL::deltaTime = deltaTimeCache;
+	}
+
+	int VFXTraceReplay::GetMismatchCount() const
+	{
+		return (int)std::ranges::count(myFrames, false, &VFXReplayFrame::matches);
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Source/Graphics/FX/VFXResources.h"
+
+namespace KE
+{
+	class VFXManager;
+
+	constexpr uint32_t VFX_TRACE_MAGIC = 0x5446564B; //"KVFT"
+	constexpr uint32_t VFX_TRACE_VERSION = 1;
+
+	enum class VFXTraceEvent : uint8_t
+	{
+		Sequence,		//first use of a sequence index, maps it to its name
+		Transform,		//an attached transform changed since it was last written
+		FrameBegin,		//delta time and view positions for the next update
+		FrameEnd,		//the update ran, carries the hash of the packages it produced
+		Trigger,
+		Stop,
+		StopInstance,
+		Seek,
+		SetTransform,
+	};
+
+	//only the values that end up on screen are hashed, pointers and padding are left out
+	uint64_t HashVFXRenderPackages(std::span<const VFXSequenceRenderPackage> aPackages);
+
+	class VFXTraceRecorder
+	{
+	private:
+		std::vector<uint8_t> myData;
+		std::vector<bool> myRecordedSequences;
+		std::unordered_map<const Transform*, uint32_t> myTransformIds;
+		std::vector<DirectX::XMFLOAT4X4> myTransformMatrices; //last written matrix per id - 1
+
+		template<typename T>
+		void Write(const T& aValue);
+		void WriteSequence(int aSequenceIndex, const std::string& aSequenceName);
+		uint32_t WriteTransform(const Transform* aTransform);
+
+	public:
+		void Begin();
+		inline size_t GetSize() const { return myData.size(); }
+
+		void RecordFrameBegin(float aDeltaTime, std::span<const VFXView> aViews);
+		void RecordAttachedTransform(const Transform* aTransform);
+		void RecordFrameEnd(std::span<const VFXSequenceRenderPackage> aPackages);
+		void RecordTrigger(int aSequenceIndex, const std::string& aSequenceName, const VFXRenderInput& aRenderInput, VFXInstanceHandle aHandle);
+		void RecordStop(int aSequenceIndex, const std::string& aSequenceName, const VFXRenderInput& aRenderInput);
+		void RecordStopInstance(VFXInstanceHandle aHandle);
+		void RecordSeek(VFXInstanceHandle aHandle, int aFrame);
+		void RecordSetTransform(VFXInstanceHandle aHandle, const Transform& aTransform);
+
+		bool Save(const std::string& aFilePath) const;
+	};
+
+	struct VFXReplayFrame
+	{
+		double updateMicroseconds = 0.0;
+		uint32_t packageCount = 0;
+		bool matches = true;
+	};
+
+	//feeds a recorded trace through the manager's update, one update per recorded frame
+	class VFXTraceReplay
+	{
+	private:
+		VFXManager& myManager;
+		std::vector<uint8_t> myData;
+		size_t myCursor = 0;
+
+		std::unordered_map<int, int> mySequences;
+		std::unordered_map<VFXInstanceHandle, VFXInstanceHandle> myHandles;
+		std::unordered_map<uint32_t, std::unique_ptr<Transform>> myTransforms; //attached inputs need stable addresses
+		std::vector<Vector3f> myViewPositions;
+		float myDeltaTime = 0.0f;
+
+		std::vector<VFXReplayFrame> myFrames;
+
+		template<typename T>
+		T Read();
+		Transform& GetTransform(uint32_t anId);
+		VFXRenderInput ReadRenderInput();
+		void ReplayFrame(uint64_t aRecordedHash, uint32_t aRecordedPackageCount);
+
+	public:
+		VFXTraceReplay(VFXManager& aManager) : myManager(aManager) {}
+
+		bool Load(const std::string& aFilePath);
+		const std::vector<VFXReplayFrame>& Run();
+
+		inline const std::vector<VFXReplayFrame>& GetFrames() const { return myFrames; }
+		int GetMismatchCount() const;
+	};
+}
@@ -0,0 +1,284 @@
+#include "stdafx.h"
+#include "VFXValidation.h"
+
+#ifdef KE_VFX_VALIDATION
+#include "VFXBenchmark.h"
+#include "VFXBloom.h"
+#include "VFXManager.h"
+#include "VFXMeshAnalysis.h"
+#include "VFXTextureAtlas.h"
+#include "Utility/Logging.h"
+
+namespace KE
+{
+	namespace
+	{
+		constexpr const char* VFX_VALIDATION_SEQUENCE_NAME = "__VFXValidation";
+		constexpr int VFX_VALIDATION_SEQUENCE_COUNT = 2;
+
+		bool IsNearlyEqual(const Vector4f& a, const Vector4f& b)
+		{
+			constexpr float epsilon = 1e-6f;
+			return std::abs(a.x - b.x) < epsilon && std::abs(a.y - b.y) < epsilon && std::abs(a.z - b.z) < epsilon && std::abs(a.w - b.w) < epsilon;
+		}
+
+		bool IsSameRect(const VFXScreenRect& a, const VFXScreenRect& b)
+		{
+			return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+		}
+	}
+
+	VFXValidation::VFXValidation(VFXManager& aManager) : myManager(aManager)
+	{
+	}
+
+	const std::vector<std::string>& VFXValidation::Run()
+	{
+		myFailures.clear();
+		myManager.ClearVFX();
+
+		ValidateMemoryStats();
+		ValidateTextureAtlas();
+		ValidateMeshAnalysis();
+		ValidateBloomRects();
+
+		myManager.ClearVFX();
+		return myFailures;
+	}
+
+	void VFXValidation::ValidateMemoryStats()
+	{
+		//reuse the sequences of an earlier run instead of growing the manager every time
+		const VFXSyntheticSequenceDesc desc;
+		mySequenceIndices.clear();
+		for (int i = 0; i < VFX_VALIDATION_SEQUENCE_COUNT; i++)
+		{
+			const std::string name = std::format("{}_{}", VFX_VALIDATION_SEQUENCE_NAME, i);
+			const auto existing = std::ranges::find(myManager.myVFXSequences, name, &VFXSequence::myName);
+			const int index = existing != myManager.myVFXSequences.end() ? existing->myIndex : myManager.AddVFXSequence(name);
+
+			VFXSyntheticSequenceDesc sequenceDesc = desc;
+			sequenceDesc.seed += i;
+			GenerateSyntheticVFXSequence(*myManager.GetVFXSequence(index), sequenceDesc);
+			mySequenceIndices.push_back(index);
+		}
+
+		//the generator reserves exactly, so every sequence of the desc owns the same known amount
+		const size_t timestampCount = desc.meshTimestamps + desc.emitterTimestamps;
+		const size_t curveCount = std::clamp(desc.curvesPerTimestamp, 0, (int)VFXAttributeTypes::Count);
+		const size_t pointCount = std::max(desc.pointsPerCurve, 2);
+		const size_t particleBytes = VFX_PARTICLE_EMITTER_CAPACITY * sizeof(decltype(SpriteBatch::myInstances)::value_type);
+
+		std::array<size_t, (int)VFXMemoryCategory::Count> expected{};
+		expected[(int)VFXMemoryCategory::Curves] = timestampCount * curveCount * pointCount * sizeof(Vector2f);
+		expected[(int)VFXMemoryCategory::Timestamps] = timestampCount * sizeof(VFXTimeStamp);
+		expected[(int)VFXMemoryCategory::MeshInstances] = desc.meshTimestamps * sizeof(VFXMeshInstance);
+		expected[(int)VFXMemoryCategory::EmitterTemplates] = desc.emitterTimestamps * (sizeof(VFXEmitter) + particleBytes);
+
+		//players that haven't updated yet own nothing but themselves, their caches and emitter copies are filled by the update
+		const int playersPerSequence = 3;
+		myTransforms.resize(playersPerSequence * mySequenceIndices.size());
+		for (int i = 0; i < myTransforms.size(); i++)
+		{
+			myManager.TriggerVFXSequence(mySequenceIndices[i % mySequenceIndices.size()], VFXRenderInput(myTransforms[i], true, true));
+		}
+		expected[(int)VFXMemoryCategory::PlayerState] = playersPerSequence * sizeof(VFXSequencePlayerData);
+
+		const VFXMemoryStats stats = myManager.GetMemoryStats(); //a copy, the manager reuses its stats
+		for (const int index : mySequenceIndices)
+		{
+			for (int c = 0; c < (int)VFXMemoryCategory::Count; c++)
+			{
+				const size_t bytes = stats.mySequences[index].myBytes[c];
+				Expect(bytes == expected[c], "Memory/{}/{}: expected {} bytes, got {}", myManager.GetVFXSequenceName(index), VFXMemoryCategoryNames[c], expected[c], bytes);
+			}
+		}
+
+		//stopped players give their state back, what the sequences own stays
+		myManager.ClearVFX();
+		const VFXMemoryStats& cleared = myManager.GetMemoryStats();
+		for (const int index : mySequenceIndices)
+		{
+			const size_t playerBytes = cleared.mySequences[index].myBytes[(int)VFXMemoryCategory::PlayerState];
+			const size_t ownedBytes = stats.mySequences[index].GetTotal() - expected[(int)VFXMemoryCategory::PlayerState];
+			Expect(playerBytes == 0, "Memory/{}/Cleared: expected 0 bytes, got {}", myManager.GetVFXSequenceName(index), playerBytes);
+			Expect(cleared.mySequences[index].GetTotal() == ownedBytes, "Memory/{}/Owned: expected {} bytes, got {}", myManager.GetVFXSequenceName(index), ownedBytes, cleared.mySequences[index].GetTotal());
+		}
+	}
+
+	void VFXValidation::ValidateTextureAtlas()
+	{
+		//28 pads to 32, so four fit on a 64 page in two shelves and the fifth starts the next page
+		constexpr int pageSize = 64;
+		constexpr int padding = 4;
+		const std::vector<VFXAtlasSize> sizes = { { 28, 28 }, { 28, 28 }, { 64, 64 }, { 28, 28 }, { 0, 16 }, { 28, 28 }, { 28, 28 } };
+		const std::vector<VFXAtlasRect> rects = PackVFXAtlas(sizes, pageSize, padding);
+		Expect(rects.size() == sizes.size(), "Atlas/Pack: expected {} rects, got {}", sizes.size(), rects.size());
+		if (rects.size() != sizes.size()) { return; }
+
+		//page, x, y. unplaced rects only need the page to match
+		const std::vector<std::array<int, 3>> expected = { { 0, 0, 0 }, { 0, 32, 0 }, { -1, 0, 0 }, { 0, 0, 32 }, { -1, 0, 0 }, { 0, 32, 32 }, { 1, 0, 0 } };
+		for (int i = 0; i < rects.size(); i++)
+		{
+			const VFXAtlasRect& rect = rects[i];
+			const auto& [page, x, y] = expected[i];
+			Expect(rect.page == page && (page < 0 || (rect.x == x && rect.y == y)),
+				"Atlas/Pack: rect {} expected page {} at {},{}, got page {} at {},{}", i, page, x, y, rect.page, rect.x, rect.y);
+		}
+
+		//mixed sizes, every placed rect has to stay on its page, aligned and apart from the others with its padding
+		const std::vector<VFXAtlasSize> mixed = { { 10, 50 }, { 33, 7 }, { 17, 17 }, { 60, 3 }, { 5, 30 }, { 21, 40 }, { 12, 12 }, { 40, 20 } };
+		const std::vector<VFXAtlasRect> mixedRects = PackVFXAtlas(mixed, pageSize, padding);
+		for (int i = 0; i < mixedRects.size(); i++)
+		{
+			const VFXAtlasRect& a = mixedRects[i];
+			Expect(a.page >= 0, "Atlas/Pack: mixed rect {} wasn't placed", i);
+			if (a.page < 0) { continue; }
+
+			Expect(a.x % padding == 0 && a.y % padding == 0 && a.x + a.width + padding <= pageSize && a.y + a.height + padding <= pageSize,
+				"Atlas/Pack: mixed rect {} at {},{} is unaligned or off its page", i, a.x, a.y);
+			for (int j = i + 1; j < mixedRects.size(); j++)
+			{
+				const VFXAtlasRect& b = mixedRects[j];
+				const bool isOverlapping = a.page == b.page &&
+					a.x < b.x + b.width + padding && b.x < a.x + a.width + padding && a.y < b.y + b.height + padding && b.y < a.y + a.height + padding;
+				Expect(!isOverlapping, "Atlas/Pack: mixed rects {} and {} overlap", i, j);
+			}
+		}
+
+		//a full page leaves its shelf alone, the next page starts on a fresh one
+		VFXAtlasShelf shelf = { 64, 32, 32 };
+		VFXAtlasRect shelfRect;
+		Expect(!PlaceOnVFXAtlasShelf(shelf, { 28, 28 }, shelfRect, pageSize, padding) && shelf.x == 64 && shelf.y == 32 && shelf.height == 32,
+			"Atlas/Shelf: a full page took the rect or moved its shelf to {},{}", shelf.x, shelf.y);
+
+		//the second rect covers the top right 28x28 of the page
+		const Vector4f uvTransform = GetVFXAtlasUVTransform(rects[1], pageSize);
+		const auto expectUV = [this](const char* aName, const Vector4f& anExpected, const Vector4f& anActual)
+		{
+			Expect(IsNearlyEqual(anExpected, anActual), "Atlas/{}: expected {},{},{},{}, got {},{},{},{}", aName,
+				anExpected.x, anExpected.y, anExpected.z, anExpected.w, anActual.x, anActual.y, anActual.z, anActual.w);
+		};
+		expectUV("UVTransform", { 0.5f, 0.0f, 0.4375f, 0.4375f }, uvTransform);
+		expectUV("RemapFull", { 0.5f, 0.0f, 0.4375f, 0.4375f }, RemapVFXAtlasUV({ 0.0f, 0.0f, 1.0f, 1.0f }, uvTransform));
+		expectUV("RemapFrame", { 0.71875f, 0.21875f, 0.21875f, 0.21875f }, RemapVFXAtlasUV({ 0.5f, 0.5f, 0.5f, 0.5f }, uvTransform));
+	}
+
+	void VFXValidation::ValidateMeshAnalysis()
+	{
+		const auto expectShape = [this](const char* aName, VFXMeshShape anExpected, std::span<const Vector3f> somePositions, std::span<const uint32_t> someIndices)
+		{
+			const VFXMeshShape shape = ClassifyVFXMesh(somePositions, someIndices);
+			Expect(shape == anExpected, "MeshAnalysis/{}: expected {}, got {}", aName, VFXMeshShapeNames[(int)anExpected], VFXMeshShapeNames[(int)shape]);
+		};
+		const auto addQuad = [](std::vector<uint32_t>& someIndices, const std::array<uint32_t, 4>& aQuad)
+		{
+			someIndices.insert(someIndices.end(), { aQuad[0], aQuad[1], aQuad[2], aQuad[0], aQuad[2], aQuad[3] });
+		};
+
+		//corner i of the unit cube sits at x = bit 0, y = bit 1, z = bit 2
+		std::vector<Vector3f> corners;
+		for (int i = 0; i < 8; i++) { corners.push_back({ (float)(i & 1), (float)(i >> 1 & 1), (float)(i >> 2 & 1) }); }
+		const std::array<std::array<uint32_t, 4>, 6> cubeFaces = { {
+			{ 0, 2, 6, 4 }, { 1, 5, 7, 3 },
+			{ 0, 4, 5, 1 }, { 2, 3, 7, 6 },
+			{ 0, 1, 3, 2 }, { 4, 6, 7, 5 }
+		} };
+		constexpr int topFace = 3;
+
+		//the z = 0 face on its own, and the same face with a back side
+		std::vector<uint32_t> plane;
+		addQuad(plane, cubeFaces[4]);
+		std::vector<uint32_t> card = plane;
+		addQuad(card, { 0, 2, 3, 1 });
+		expectShape("Plane", VFXMeshShape::Open, corners, plane);
+		expectShape("Card", VFXMeshShape::Open, corners, card);
+
+		std::vector<uint32_t> cube;
+		for (const auto& face : cubeFaces) { addQuad(cube, face); }
+		expectShape("Cube", VFXMeshShape::Closed, corners, cube);
+		expectShape("OpenBox", VFXMeshShape::Open, corners, std::span(cube).first(cube.size() - 6));
+
+		//split along every face like an exported cube with hard normals, only closed once the seams are welded
+		std::vector<Vector3f> splitCorners;
+		std::vector<uint32_t> splitCube;
+		for (const auto& face : cubeFaces)
+		{
+			const uint32_t first = (uint32_t)splitCorners.size();
+			for (const uint32_t corner : face) { splitCorners.push_back(corners[corner]); }
+			addQuad(splitCube, { first, first + 1, first + 2, first + 3 });
+		}
+		expectShape("SplitCube", VFXMeshShape::Closed, splitCorners, splitCube);
+
+		//the top pushed in to a point in the middle of the cube
+		std::vector<Vector3f> dentedCorners = corners;
+		dentedCorners.push_back({ 0.5f, 0.5f, 0.5f });
+		std::vector<uint32_t> dented;
+		for (int f = 0; f < cubeFaces.size(); f++)
+		{
+			if (f != topFace) { addQuad(dented, cubeFaces[f]); }
+		}
+		const auto& top = cubeFaces[topFace];
+		for (int i = 0; i < 4; i++) { dented.insert(dented.end(), { top[i], top[(i + 1) % 4], 8u }); }
+		expectShape("Concave", VFXMeshShape::Closed, dentedCorners, dented);
+
+		//what the renderer is handed, one rasterizer state and draw per pass
+		const auto expectPasses = [this](const char* aName, VFXMeshShape aShape, VFXMeshDrawMode aDrawMode, std::initializer_list<VFXMeshPass> someExpected)
+		{
+			const VFXMeshPasses passes = GetVFXMeshPasses(aShape, aDrawMode);
+			Expect(passes.count == (int)someExpected.size() && std::equal(someExpected.begin(), someExpected.end(), passes.passes.begin()),
+				"MeshAnalysis/{}: expected {} pass(es), got {}", aName, someExpected.size(), passes.count);
+		};
+		expectPasses("OpenAuto", VFXMeshShape::Open, VFXMeshDrawMode::Auto, { VFXMeshPass::BothFaces });
+		expectPasses("ClosedAuto", VFXMeshShape::Closed, VFXMeshDrawMode::Auto, { VFXMeshPass::BackFaces, VFXMeshPass::FrontFaces });
+		expectPasses("OpenTwoPass", VFXMeshShape::Open, VFXMeshDrawMode::TwoPass, { VFXMeshPass::BackFaces, VFXMeshPass::FrontFaces });
+		expectPasses("ClosedSinglePass", VFXMeshShape::Closed, VFXMeshDrawMode::SinglePass, { VFXMeshPass::BothFaces });
+	}
+
+	void VFXValidation::ValidateBloomRects()
+	{
+		const auto expectRect = [this](const char* aName, const VFXScreenRect& anExpected, const VFXScreenRect& anActual)
+		{
+			Expect(IsSameRect(anExpected, anActual), "Bloom/{}: expected {},{} {},{}, got {},{} {},{}", aName,
+				anExpected.left, anExpected.top, anExpected.right, anExpected.bottom, anActual.left, anActual.top, anActual.right, anActual.bottom);
+		};
+
+		//with an identity view projection world xy is ndc, the sizes are picked so every edge lands on an exact float
+		constexpr int width = 200;
+		constexpr int height = 100;
+		constexpr int padding = 4;
+		const DirectX::XMMATRIX identity = DirectX::XMMatrixIdentity();
+		const auto getRect = [&](std::initializer_list<VFXBloomContributor> someContributors, const DirectX::XMMATRIX& aViewProjection)
+		{
+			return GetVFXBloomRect(std::span(someContributors.begin(), someContributors.size()), aViewProjection, width, height, padding);
+		};
+
+		expectRect("NoContributors", {}, GetVFXBloomRect({}, identity, width, height, padding));
+		expectRect("Centered", { 71, 33, 129, 67 }, getRect({ { { 0.0f, 0.0f, 0.0f }, 0.25f } }, identity));
+		expectRect("Union", { 21, 33, 179, 67 }, getRect({ { { -0.5f, 0.0f, 0.0f }, 0.25f }, { { 0.5f, 0.0f, 0.0f }, 0.25f } }, identity));
+		expectRect("ClampedToEdges", { 158, 0, 200, 23 }, getRect({ { { 0.875f, 0.875f, 0.0f }, 0.25f } }, identity));
+		expectRect("OffScreen", {}, getRect({ { { 3.0f, 3.0f, 0.0f }, 0.25f } }, identity));
+
+		//a perspective projection puts view space depth in w, anything behind the camera can't be projected
+		const DirectX::XMMATRIX perspective = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV2, (float)width / (float)height, 0.1f, 100.0f);
+		expectRect("BehindCamera", { 0, 0, width, height }, getRect({ { { 0.0f, 0.0f, -5.0f }, 0.25f } }, perspective));
+
+		//the left and top round down, the right and bottom round up
+		const VFXScreenRect rect = { 71, 33, 129, 67 };
+		expectRect("Downsample0", rect, GetVFXDownsampledRect(rect, 0));
+		expectRect("Downsample1", { 35, 16, 65, 34 }, GetVFXDownsampledRect(rect, 1));
+		expectRect("Downsample2", { 17, 8, 33, 17 }, GetVFXDownsampledRect(rect, 2));
+	}
+
+	int RunVFXValidation(VFXManager& aManager)
+	{
+		VFXValidation validation(aManager);
+		const std::vector<std::string>& failures = validation.Run();
+		for (const std::string& failure : failures)
+		{
+			KE_ERROR("VFX validation failed: %s", failure.c_str());
+		}
+		return (int)failures.size();
+	}
+}
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+#include "Engine/Source/Graphics/FX/VFXProfiler.h"
+
+//the checks only exist in builds with the editor, same as the profiler
+#ifdef KE_VFX_PROFILING
+#define KE_VFX_VALIDATION
+#endif
+
+#ifdef KE_VFX_VALIDATION
+#include <format>
+#include <string>
+#include <vector>
+
+#include "Engine/Source/Graphics/FX/VFXResources.h"
+
+namespace KE
+{
+	class VFXManager;
+
+	//runs known workloads through the vfx system and checks what comes out
+	class VFXValidation
+	{
+	private:
+		VFXManager& myManager;
+		std::vector<std::string> myFailures;
+		std::vector<int> mySequenceIndices;
+		std::vector<Transform> myTransforms;
+
+		template<typename... Args>
+		void Expect(bool aPassed, std::format_string<Args...> aFormat, Args&&... someArgs)
+		{
+			if (aPassed) { return; }
+			myFailures.push_back(std::format(aFormat, std::forward<Args>(someArgs)...));
+		}
+
+		void ValidateMemoryStats();
+		void ValidateTextureAtlas();
+		void ValidateMeshAnalysis();
+		void ValidateBloomRects();
+
+	public:
+		explicit VFXValidation(VFXManager& aManager);
+
+		//one line per failed check. clears every playing vfx before and after
+		const std::vector<std::string>& Run();
+	};
+
+	//logs every failed check and returns how many there were, a validation step fails on anything but 0
+	int RunVFXValidation(VFXManager& aManager);
+}
+#endif